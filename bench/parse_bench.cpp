@@ -0,0 +1,105 @@
+// Compares the parse loop of ParseSession with the threaded interpreter of
+// ThreadedSession on the same lexed input.
+//
+// Usage: parse_bench <grammar_file> <input_file> [min_tokens]
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../include/lexer.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/parse_session.hpp"
+#include "../include/symbol_table.hpp"
+#include "../include/threaded_session.hpp"
+
+namespace {
+
+/// @brief Number of timed runs of each engine, the fastest is kept.
+constexpr int kRuns{5};
+
+/// @brief Best time of `kRuns` runs of `repetitions` parses, in nanoseconds.
+template <typename Session>
+double Time(Session& session, const std::vector<symbol_id>& tokens,
+            std::size_t repetitions, bool& accepted) {
+    double best{0};
+    for (int run = 0; run < kRuns; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < repetitions; ++i) {
+            accepted = session.Parse(tokens);
+        }
+        std::chrono::duration<double, std::nano> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <grammar_file> <input_file> [min_tokens]\n";
+        return 1;
+    }
+    try {
+        LL1Parser parser{argv[1]};
+        std::ifstream in(argv[2]);
+        if (!in) {
+            std::cerr << "Cannot read " << argv[2] << "\n";
+            return 1;
+        }
+        std::string text{std::istreambuf_iterator<char>(in), {}};
+
+        std::vector<symbol_id> tokens;
+        Lex                    lex{parser.GetGrammar().st_};
+        lex.Reset(text);
+        for (auto chunk = lex.NextChunk(); !chunk.empty();
+             chunk      = lex.NextChunk()) {
+            tokens.insert(tokens.end(), chunk.begin(), chunk.end());
+        }
+        if (tokens.empty()) {
+            std::cerr << "No tokens in " << argv[2] << "\n";
+            return 1;
+        }
+        // Parse the input again until enough tokens went through
+        std::size_t min_tokens = argc > 3 ? std::stoul(argv[3]) : 20'000'000;
+        std::size_t repetitions =
+            std::max<std::size_t>(1, min_tokens / tokens.size());
+        double total = static_cast<double>(tokens.size() * repetitions);
+
+        ParseSession    loop{parser, 0};
+        ThreadedSession threaded{parser};
+        bool            loop_accepted{false}, threaded_accepted{false};
+        double loop_ns = Time(loop, tokens, repetitions, loop_accepted);
+        double threaded_ns =
+            Time(threaded, tokens, repetitions, threaded_accepted);
+
+        std::cout << tokens.size() << " tokens x " << repetitions
+                  << " parses, input "
+                  << (loop_accepted ? "accepted" : "rejected") << "\n"
+                  << std::fixed << std::setprecision(2)
+                  << "ParseSession::Parse     " << loop_ns / total
+                  << " ns/token\n"
+                  << "ThreadedSession::Parse  " << threaded_ns / total
+                  << " ns/token ("
+                  << (ThreadedSession::kComputedGoto ? "computed goto"
+                                                     : "switch")
+                  << "), speedup " << loop_ns / threaded_ns << "x\n";
+        if (loop_accepted != threaded_accepted) {
+            std::cerr << "The engines disagree on the input\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Bump allocator for objects that are all freed at once.
+ *
+ * Memory is handed out from large blocks by advancing a pointer, and
+ * individual objects are never freed: `Clear` releases every allocation in
+ * one shot, keeping the blocks to be reused by the next allocations.
+ */
+class Arena {
+  public:
+    /// @brief Default size of each block, in bytes.
+    static constexpr std::size_t kDefaultBlockSize{1 << 16};
+
+    /**
+     * @brief Constructs an empty arena.
+     *
+     * @param block_size Size of each block, in bytes. Larger allocations get
+     * a block of their own.
+     */
+    explicit Arena(std::size_t block_size = kDefaultBlockSize)
+        : block_size_(block_size) {}
+
+    /**
+     * @brief Allocates `n` value-initialized objects.
+     *
+     * @tparam T Object type; it must be trivially destructible, since
+     * destructors are never run.
+     * @param n Number of objects.
+     * @return Pointer to the first object, or null if `n` is 0. It stays
+     * valid until `Clear` is called or the arena is destroyed.
+     */
+    template <typename T> T* Allocate(std::size_t n) {
+        static_assert(std::is_trivially_destructible_v<T>);
+        if (n == 0) {
+            return nullptr;
+        }
+        auto* objects =
+            static_cast<T*>(AllocateBytes(n * sizeof(T), alignof(T)));
+        std::uninitialized_value_construct_n(objects, n);
+        return objects;
+    }
+
+    /// @brief Releases every allocation, keeping the blocks for reuse.
+    void Clear() {
+        current_ = 0;
+        used_    = 0;
+    }
+
+  private:
+    /// @brief Memory block handed out by the arena.
+    struct block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t                  size;
+    };
+
+    /**
+     * @brief Allocates raw memory from the current block, moving to the next
+     * block, or creating one, if it does not fit.
+     *
+     * @param size Number of bytes.
+     * @param align Required alignment, at most that of `operator new`.
+     */
+    void* AllocateBytes(std::size_t size, std::size_t align);
+
+    /// @brief Size of the blocks created by the arena.
+    std::size_t block_size_;
+
+    /// @brief Blocks, in allocation order.
+    std::vector<block> blocks_;
+
+    /// @brief Index of the block being filled.
+    std::size_t current_{0};
+
+    /// @brief Bytes used in the block being filled.
+    std::size_t used_{0};
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include "ll1_parser.hpp"
+#include "symbol_table.hpp"
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Generator of a self-contained C++ parser for a grammar.
+ *
+ * The generated source holds the LL(1) table of an `LL1Parser` as static
+ * arrays, with the terminal IDs, the push sequence of each production and a
+ * small table-driven parser over them. It only needs the standard library, so
+ * it can be compiled into a program that parses the language with no grammar
+ * file, no grammar parsing and no table construction at startup. Lexing is
+ * left to the program: the parser takes token IDs, the regex of each terminal
+ * is emitted alongside to build a lexer with.
+ */
+class CppEmitter {
+  public:
+    /**
+     * @brief Constructs an emitter for a parser.
+     *
+     * @param parser Compiled grammar to emit; it must outlive the emitter.
+     * @param name Namespace of the generated code, made a valid identifier:
+     * `ll1_` is prepended if it is empty or starts with a digit, and `_`
+     * appended if it is a C++ keyword.
+     */
+    CppEmitter(const LL1Parser& parser, std::string_view name);
+
+    /**
+     * @brief Writes the generated source.
+     *
+     * @param out Stream to write to.
+     */
+    void Emit(std::ostream& out) const;
+
+    /**
+     * @brief Writes the tables as a header, to parse with `TableParser`.
+     *
+     * The header holds a struct named after the emitter, whose members are
+     * the terminal IDs and `static constexpr` arrays: the symbol names, the
+     * productions in CSR layout, the LL(1) table and the nullable
+     * non-terminals. It includes nothing but `<cstdint>`.
+     *
+     * @param out Stream to write to.
+     */
+    void EmitHeader(std::ostream& out) const;
+
+  private:
+    /// @brief How the constants are declared, in a namespace or a struct.
+    struct layout {
+        /// @brief Indentation of every line.
+        std::string_view indent;
+        /// @brief Specifiers of every constant.
+        std::string_view storage;
+    };
+
+    /// @brief Writes the enumerator of every terminal.
+    void EmitTerminals(std::ostream& out, layout l) const;
+
+    /// @brief Writes the symbol counts, names and terminal regexes.
+    void EmitSymbols(std::ostream& out, layout l) const;
+
+    /// @brief Writes the LL(1) table, one row per non-terminal.
+    void EmitTable(std::ostream& out, layout l) const;
+
+    /// @brief Writes the productions: right-hand sides and left-hand sides.
+    void EmitRules(std::ostream& out, layout l) const;
+
+    /// @brief Writes the nullable non-terminals and their empty productions.
+    void EmitNullable(std::ostream& out, layout l) const;
+
+    /// @brief Writes the push sequences and the empty productions.
+    void EmitProductions(std::ostream& out) const;
+
+    /// @brief Replaces every character not valid in an identifier by `_`.
+    static std::string Identifier(std::string_view name);
+
+    /// @brief Quotes and escapes a string as a C++ literal.
+    static std::string Literal(std::string_view text);
+
+    /// @brief Compiled grammar to emit.
+    const LL1Parser& parser_;
+
+    /// @brief Symbols of the grammar.
+    const symbol_table& st_;
+
+    /// @brief Namespace of the generated code, or struct of the header.
+    std::string name_;
+};
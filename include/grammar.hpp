@@ -1,11 +1,19 @@
 #pragma once
+#include "symbol_table.hpp"
+#include <cstdint>
+#include <ranges>
+#include <span>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
-using production = std::vector<std::string>;
+using production = std::vector<symbol_id>;
 
 struct Grammar {
+    /**
+     * @brief Sentinel production index meaning "no production". It fits in
+     * 31 bits so it can be stored in an LL(1) table cell.
+     */
+    static constexpr std::uint32_t kNoProduction{0x7FFFFFFF};
 
     /**
      * @brief Constructs a grammar by reading from the specified file.
@@ -24,6 +32,10 @@ struct Grammar {
      * each rule and storing it in the grammar structure. The file format
      * requirements are outlined in the README.md.
      *
+     * Every symbol is interned in the symbol table while reading: terminals
+     * get IDs in declaration order, non-terminals follow them in order of
+     * first appearance as antecedent.
+     *
      * @throws GrammarError if there are errors reading symbols, parsing the
      * grammar, or splitting the rules as specified in the input file.
      */
@@ -32,50 +44,125 @@ struct Grammar {
     /**
      * @brief Adds a rule to the grammar.
      *
-     * @param antecedent The left-hand side (LHS) symbol of the rule.
+     * @param antecedent The left-hand side (LHS) non-terminal of the rule.
      * @param consequent The right-hand side (RHS) of the rule as a string.
      *
      * Adds a rule to the grammar by specifying the antecedent symbol and the
      * consequent production. This function processes and adds each rule for
-     * parsing.
+     * parsing. The right-hand side is appended to `rhs_`, so rules must be
+     * added grouped by antecedent, in increasing ID order.
+     *
+     * @throws GrammarError if the rules of `antecedent` were already closed by
+     * rules of a later non-terminal.
      */
-    void AddRule(const std::string& antecedent, const std::string& consequent);
+    void AddRule(symbol_id antecedent, const std::string& consequent);
 
     /**
      * @brief Sets the axiom (entry point) of the grammar.
      *
-     * @param axiom The entry point or start symbol of the grammar.
+     * @param axiom ID of the entry point or start symbol of the grammar.
      *
      * Defines the starting point for the grammar, which is used in parsing
      * algorithms and must be a non-terminal symbol present in the grammar.
      */
-    void SetAxiom(const std::string& axiom);
+    void SetAxiom(symbol_id axiom);
 
     /**
      * @brief Checks if a given antecedent has an empty production.
      *
-     * @param antecedent The left-hand side (LHS) symbol to check.
+     * @param antecedent The left-hand side (LHS) non-terminal to check.
      * @return true if there exists an empty production for the antecedent,
      *         otherwise false.
      *
      * An empty production is represented as `<antecedent> -> ;`, indicating
-     * that the antecedent can produce an empty string.
+     * that the antecedent can produce an empty string. The answer is
+     * precomputed by `ComputeNullable`, so this is a single load.
+     */
+    bool HasEmptyProduction(symbol_id antecedent) const {
+        return EmptyProduction(antecedent) != kNoProduction;
+    }
+
+    /**
+     * @brief Index of the empty production of a non-terminal.
+     *
+     * @param antecedent The left-hand side (LHS) non-terminal.
+     * @return The index of its first `<antecedent> -> ;` production, or
+     * `kNoProduction` if it has none.
+     */
+    std::uint32_t EmptyProduction(symbol_id antecedent) const {
+        return empty_production_[st_.NonTerminalIndex(antecedent)];
+    }
+
+    /**
+     * @brief Checks if a non-terminal is nullable.
+     *
+     * @param antecedent Non-terminal symbol ID.
+     * @return true if the non-terminal can derive the empty string, or reach
+     * the end-of-line symbol through nullable symbols only.
+     */
+    bool IsNullable(symbol_id antecedent) const {
+        return nullable_[st_.NonTerminalIndex(antecedent)];
+    }
+
+    /**
+     * @brief Computes which non-terminals are nullable and the empty
+     * production of each one.
+     *
+     * Called once the grammar is loaded. A production is nullable if every
+     * symbol before the first EOL symbol is nullable: EOL ends the input, so
+     * whatever follows it is never derived. Runs in time linear in the size
+     * of the grammar, revisiting a production only when one of its
+     * non-terminals becomes nullable.
      */
-    bool HasEmptyProduction(const std::string& antecedent);
+    void ComputeNullable();
 
     /**
      * @brief Filters grammar rules that contain a specific token in their
      * consequent.
      *
      * @param arg The token to search for within the consequents of the rules.
-     * @return std::vector of pairs where each pair contains an antecedent and
-     * its respective production that includes the specified token.
+     * @return std::vector with the index of every production that includes the
+     * specified token.
      *
      * Searches for rules in which the specified token is part of the consequent
      * and returns those rules.
      */
-    std::vector<std::pair<const std::string, production>>
-    FilterRulesByConsequent(const std::string& arg);
+    std::vector<std::uint32_t> FilterRulesByConsequent(symbol_id arg);
+
+    /// @brief Number of productions of the grammar.
+    std::uint32_t NumProductions() const {
+        return static_cast<std::uint32_t>(prod_lhs_.size());
+    }
+
+    /**
+     * @brief Indices of the productions of a non-terminal, which are
+     * contiguous.
+     *
+     * @param antecedent Non-terminal symbol ID.
+     */
+    std::ranges::iota_view<std::uint32_t, std::uint32_t>
+    Productions(symbol_id antecedent) const {
+        symbol_id i{st_.NonTerminalIndex(antecedent)};
+        return {nt_offsets_[i], nt_offsets_[i + 1]};
+    }
+
+    /**
+     * @brief Right-hand side of a production.
+     *
+     * @param p Production index.
+     * @return View over the production symbols inside `rhs_`.
+     */
+    std::span<const symbol_id> Rhs(std::uint32_t p) const {
+        return {rhs_.data() + prod_offsets_[p],
+                rhs_.data() + prod_offsets_[p + 1]};
+    }
+
+    /**
+     * @brief Left-hand side of a production.
+     *
+     * @param p Production index.
+     */
+    symbol_id Lhs(std::uint32_t p) const { return prod_lhs_[p]; }
 
     /**
      * @brief Prints the current grammar structure to standard output.
@@ -89,20 +176,20 @@ struct Grammar {
      * @brief Splits a production string into individual tokens.
      *
      * @param s The production string to split.
-     * @return std::vector containing tokens extracted from the production
+     * @return The production, as the IDs of the symbols extracted from the
      * string.
      *
      * The function decomposes a production string into individual symbols based
-     * on the symbol table, allowing terminals and non-terminals to be
+     * on the grammar's symbol table, allowing terminals and non-terminals to be
      * identified.
      */
-    static std::vector<std::string> Split(const std::string& s);
+    production Split(const std::string& s) const;
 
     /**
      * @brief Checks if a rule exhibits left recursion.
      *
      * @param antecedent The left-hand side (LHS) symbol of the rule.
-     * @param consequent The right-hand side (RHS) vector of tokens of the rule.
+     * @param consequent The right-hand side (RHS) symbols of the rule.
      * @return true if the rule has left recursion (e.g., A -> A + A), otherwise
      * false.
      *
@@ -110,19 +197,54 @@ struct Grammar {
      * first symbol in its consequent, which may cause issues in top-down
      * parsing algorithms.
      */
-    static bool HasLeftRecursion(const std::string&              antecedent,
-                                 const std::vector<std::string>& consequent);
+    static bool HasLeftRecursion(symbol_id                  antecedent,
+                                 std::span<const symbol_id> consequent);
+
+    /**
+     * @brief Symbols of this grammar, filled while reading the file.
+     */
+    symbol_table st_;
+
+    /**
+     * @brief Symbols of every right-hand side, concatenated in production
+     * order.
+     */
+    std::vector<symbol_id> rhs_;
+
+    /**
+     * @brief Offset of each production in `rhs_`. Production `p` spans
+     * `[prod_offsets_[p], prod_offsets_[p + 1])`.
+     */
+    std::vector<std::uint32_t> prod_offsets_{0};
+
+    /**
+     * @brief Antecedent of each production.
+     */
+    std::vector<symbol_id> prod_lhs_;
+
+    /**
+     * @brief First production of each non-terminal, indexed by
+     * `symbol_table::NonTerminalIndex`. The productions of the non-terminal
+     * `i` are `[nt_offsets_[i], nt_offsets_[i + 1])`.
+     */
+    std::vector<std::uint32_t> nt_offsets_{0};
+
+    /**
+     * @brief Nullability of each non-terminal, indexed by
+     * `symbol_table::NonTerminalIndex`.
+     */
+    std::vector<bool> nullable_;
 
     /**
-     * @brief Stores the grammar rules with each antecedent mapped to a list of
-     * productions.
+     * @brief Empty production of each non-terminal, or `kNoProduction`,
+     * indexed by `symbol_table::NonTerminalIndex`.
      */
-    std::unordered_map<std::string, std::vector<production>> g_;
+    std::vector<std::uint32_t> empty_production_;
 
     /**
      * @brief The axiom or entry point of the grammar.
      */
-    std::string axiom_;
+    symbol_id axiom_{symbol_table::kNone};
 
     /**
      * @brief The filename from which the grammar is read.
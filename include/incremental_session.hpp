@@ -0,0 +1,225 @@
+#pragma once
+#include "grammar.hpp"
+#include "lexer.hpp"
+#include "ll1_parser.hpp"
+#include "symbol_table.hpp"
+#include <compare>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Parse of a document that is edited and re-parsed many times, e.g. in
+ * an editor.
+ *
+ * The document is split in blocks of whole lines, of about
+ * `kCheckpointInterval` tokens each. A block holds its text, its tokens with
+ * their byte ranges relative to the block and a snapshot of the parse stack
+ * at its first token; the sizes of the blocks are kept in prefix sums. An
+ * edit thus only touches the blocks it spans: the lines it changes are lexed
+ * again, the block is cut again if it grew too large, and no other block
+ * moves or changes.
+ *
+ * The parse then resumes from the snapshot of the first edited block. It
+ * stops as soon as it enters a block whose snapshot, taken by an earlier
+ * parse with the same text from there on, holds the same stack: from there
+ * both parses are the same, so the earlier result still holds. The
+ * snapshots an earlier parse took past the point where a later one stopped,
+ * e.g. at a syntax error, are kept too, so fixing the error converges as
+ * fast. A small edit thus costs a few blocks of lexing and parsing, whatever
+ * the size of the document.
+ *
+ * The result is always the one `ParseSession::ParseText` gives for the
+ * current text. Tokens must not cross a newline, since lines are lexed on
+ * their own.
+ */
+class IncrementalSession {
+  public:
+    /// @brief Number of tokens of a block, and so between two stack
+    /// snapshots. Blocks are cut at line boundaries once they hold twice as
+    /// many.
+    static constexpr std::size_t kCheckpointInterval{256};
+
+    /**
+     * @brief Constructs a session holding an empty document.
+     *
+     * @param parser Compiled grammar to parse with; it must outlive the
+     * session.
+     */
+    explicit IncrementalSession(const LL1Parser& parser);
+
+    /**
+     * @brief Replaces the whole document and parses it from scratch.
+     *
+     * @param text New text.
+     * @return `true` if the text is accepted, `false` otherwise.
+     *
+     * @throws LexerError If the text contains an invalid token. The session
+     * is left unchanged.
+     */
+    bool Load(std::string_view text);
+
+    /**
+     * @brief Replaces part of the document and parses it again.
+     *
+     * @param offset Byte offset of the replaced text.
+     * @param length Number of bytes replaced, 0 to insert.
+     * @param replacement Text inserted at `offset`, empty to delete.
+     * @return `true` if the new text is accepted, `false` otherwise.
+     *
+     * @throws std::out_of_range If `offset` is past the end of the text.
+     * @throws LexerError If the edited lines contain an invalid token. The
+     * session is left unchanged.
+     */
+    bool Edit(std::size_t offset, std::size_t length,
+              std::string_view replacement);
+
+    /// @brief Current text of the document, assembled from its blocks.
+    std::string Text() const;
+
+    /// @brief Size in bytes of the current text.
+    std::size_t Size() const { return bytes_.Total(); }
+
+    /// @brief Whether the current text is accepted.
+    bool Accepted() const { return outcomes_.front().status != REJECTED; }
+
+    /// @brief Byte offset of the token that made the text be rejected.
+    std::size_t ErrorOffset() const;
+
+    /// @brief Number of tokens of the current text.
+    std::size_t NumTokens() const { return num_tokens_.Total(); }
+
+    /// @brief Number of tokens the last `Load` or `Edit` had to parse.
+    std::size_t ParsedTokens() const { return parsed_tokens_; }
+
+  private:
+    /// @brief State of a parse when it stops, see `ParseSession`.
+    enum parse_status { RUNNING, ACCEPTED, REJECTED };
+
+    /// @brief Position of a token: its block and its index in the block.
+    struct position {
+        std::size_t block;
+        std::size_t token;
+        auto        operator<=>(const position&) const = default;
+    };
+
+    /// @brief How a parse stopped.
+    struct outcome {
+        parse_status status;
+        /// @brief Next token when it stopped, one past the last one if the
+        /// tokens ran out.
+        position stop;
+        /// @brief First block whose snapshot still leads to this outcome;
+        /// an edit between an earlier snapshot and `stop` made them stale.
+        std::size_t valid_from;
+    };
+
+    /// @brief Whole lines of the document with their tokens.
+    struct block {
+        std::string text;
+        /// @brief Token IDs of `text`.
+        std::vector<symbol_id> tokens;
+        /// @brief Byte range of each token in `text`.
+        std::vector<token_range> ranges;
+        /// @brief Parse stack before the first token, its top is the last
+        /// element.
+        std::vector<symbol_id> stack;
+        /// @brief Whether `stack` was taken by a parse.
+        bool has_snapshot{false};
+    };
+
+    /// @brief Prefix sums of a size per block (Fenwick tree), updated and
+    /// searched in logarithmic time.
+    class block_sums {
+      public:
+        /// @brief Rebuilds the sums from the size of every block.
+        void Build(const std::vector<std::size_t>& sizes);
+
+        /// @brief Adds `delta`, possibly wrapped negative, to block `i`.
+        void Add(std::size_t i, std::size_t delta);
+
+        /// @brief Sum of the sizes of the blocks before block `i`.
+        std::size_t Before(std::size_t i) const;
+
+        /// @brief Block holding unit `offset`, the last one past the end.
+        std::size_t Find(std::size_t offset) const;
+
+        /// @brief Sum of every size.
+        std::size_t Total() const { return total_; }
+
+      private:
+        std::vector<std::size_t> tree_;
+        std::size_t              total_{0};
+    };
+
+    /**
+     * @brief Lexes a piece of text that starts at a line boundary.
+     *
+     * @param text Text to lex.
+     * @param offset Offset of `text` in its block, added to the ranges.
+     * @param tokens Receives the token IDs.
+     * @param ranges Receives the byte range of each token.
+     */
+    void LexText(std::string_view text, std::size_t offset,
+                 std::vector<symbol_id>& tokens,
+                 std::vector<token_range>& ranges);
+
+    /**
+     * @brief Cuts a block at line boundaries into blocks of at least
+     * `kCheckpointInterval` tokens, if it holds more than twice as many.
+     *
+     * @param whole Block to cut; the first piece keeps its snapshot.
+     * @param pieces Receives the blocks.
+     */
+    static void Cut(block whole, std::vector<block>& pieces);
+
+    /// @brief Rebuilds `bytes_` and `num_tokens_` after blocks were added or
+    /// removed.
+    void IndexBlocks();
+
+    /**
+     * @brief Parses from the snapshot of block `first` until the tokens
+     * end, the parse stops or it converges with an earlier parse, and
+     * updates `outcomes_`.
+     */
+    void Resume(std::size_t first);
+
+    /**
+     * @brief Checks if the parse, entering block `b`, converges with the
+     * snapshot of an earlier parse. Skips the outcomes before the block.
+     */
+    bool Converges(std::size_t b);
+
+    /// @brief Compiled grammar shared with other sessions.
+    const LL1Parser& parser_;
+
+    /// @brief Grammar of `parser_`.
+    const Grammar& gr_;
+
+    /// @brief Blocks of the document, in order; never empty.
+    std::vector<block> blocks_;
+
+    /// @brief Size in bytes of each block.
+    block_sums bytes_;
+
+    /// @brief Number of tokens of each block.
+    block_sums num_tokens_;
+
+    /// @brief Outcome of the current parse, then of the earlier parses whose
+    /// snapshots are kept, by increasing stop. A snapshot leads to the first
+    /// outcome that stops at or after it.
+    std::vector<outcome> outcomes_;
+
+    /// @brief Next outcome a resumed parse may converge with.
+    std::size_t next_outcome_{0};
+
+    /// @brief Parse stack while parsing.
+    std::vector<symbol_id> stack_;
+
+    /// @brief Tokens parsed by the last `Load` or `Edit`.
+    std::size_t parsed_tokens_{0};
+
+    /// @brief Lexer for the grammar terminals, reused for every edit.
+    Lex lex_;
+};
@@ -1,10 +1,36 @@
+#pragma once
+#include "symbol_table.hpp"
 #include <boost/spirit/include/lex_lexertl.hpp>
+#include <cstddef>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
-class Lex {
-    std::string              filename_;
-    std::vector<std::string> tokens_;
-    unsigned                 current_;
 
+/// @brief Byte range `[begin, end)` of a token in the input.
+struct token_range {
+    std::size_t begin;
+    std::size_t end;
+};
+
+/**
+ * @brief Lexer that reads its input, a file or an in-memory buffer, in
+ * bounded chunks.
+ *
+ * Tokens are produced on demand, one chunk at a time, so memory use does not
+ * depend on the size of the input. The token definitions are built once, so a
+ * lexer can be reused for many inputs with `Open` and `Reset`. A chunk is
+ * lexed as far as it goes; its last token, which more bytes could make
+ * longer, is held back and lexed again with the next chunk, so only the new
+ * bytes are scanned and the held-back part is at most one token long. A token
+ * is thus taken as complete once another lexeme follows it, which differs
+ * from lexing the whole input when the longest match at an earlier token
+ * needs bytes past the chunk: with terminals `a`, `b` and `abc`, `abc` cut
+ * after `ab` is lexed as `a b c`. Tokens longer than `kMaxTokenSize` are
+ * rejected.
+ */
+class Lex {
   public:
     /**
      * @brief Lexer functor for defining tokenization rules using Boost Spirit
@@ -18,20 +44,29 @@ class Lex {
      * @tparam Lexer The type of lexer to be used (e.g.,
      * `boost::spirit::lex::lexertl::lexer<>`).
      *
+     * @param st Symbol table of the grammar whose terminals are recognized.
+     *
      * @details The constructor performs the following steps:
-     * 1. Iterates over the token types defined in
-     * `symbol_table::token_types_r_`.
-     * 2. Adds regular expressions and their corresponding token IDs to the
-     * lexer.
+     * 1. Iterates over the terminals defined in the symbol table.
+     * 2. Adds regular expressions to the lexer, using the terminal symbol ID
+     * as token ID.
      * 3. Skips whitespace characters (spaces, tabs, and newlines) by assigning
      * them a specific token ID.
      *
-     * @see symbol_table::token_types_r_
-     * @see symbol_table::st_
+     * @see symbol_table::regex_
      */
     template <typename Lexer>
     struct ParseInput : boost::spirit::lex::lexer<Lexer> {
-        ParseInput();
+        explicit ParseInput(const symbol_table& st);
+    };
+
+    /// @brief Bounds of the last lexeme of a chunk, skipped whitespace
+    /// included.
+    struct last_lexeme {
+        char const* begin{nullptr};
+        char const* end{nullptr};
+        /// @brief Whether the lexeme is a token and not whitespace.
+        bool is_token{false};
     };
 
     /**
@@ -44,66 +79,202 @@ class Lex {
      * @details The `operator()` method performs the following steps:
      * 1. Checks if the token ID matches a special token (e.g., whitespace) that
      * should be ignored.
-     * 2. If the token is not ignored, adds the corresponding token type (from
-     * `symbol_table::token_types_r_`) to the token list.
-     *
-     * @see symbol_table::token_types_r_
+     * 2. If the token is not ignored, adds its symbol ID to the token list,
+     * and its byte range to `ranges` if it is not null.
+     * 3. Records where the lexeme starts and ends in `last`.
      */
     struct Add {
         typedef bool result_type;
+        /// @brief Token ID assigned to whitespace, which is not stored.
+        symbol_id skip_id;
+        /// @brief Where token ranges are stored, null to not track them.
+        std::vector<token_range>* ranges;
+        /// @brief Start of the chunk being tokenized.
+        char const* chunk;
+        /// @brief Offset of `chunk` in the input.
+        std::size_t offset;
+        /// @brief Receives the last lexeme seen.
+        last_lexeme* last;
         template <typename Token>
-        bool operator()(Token const& t, std::vector<std::string>& tks) const;
+        bool operator()(Token const& t, std::vector<symbol_id>& tks) const;
     };
     /**
-     * @brief Constructs a lexer and tokenizes the specified input file.
+     * @brief Constructs a lexer over the specified input file.
+     *
+     * The file is opened but nothing is read until tokens are requested.
      *
+     * @param st Symbol table of the grammar; it must outlive the lexer.
      * @param filename Path to the input file containing the string to be
      * validated.
+     */
+    Lex(const symbol_table& st, const std::string& filename);
+
+    /**
+     * @brief Constructs a lexer with no input; every token request returns
+     * the end of the input until `Open` or `Reset` is called.
+     *
+     * @param st Symbol table of the grammar; it must outlive the lexer.
+     */
+    explicit Lex(const symbol_table& st);
+
+    /**
+     * @brief Starts lexing a new input file, discarding the current input.
+     *
+     * @param filename Path to the input file.
      *
-     * @note The program aborts if any errors occur during lexer creation or
-     * tokenization.
+     * @throws LexerError If the file cannot be opened.
      */
-    explicit Lex(std::string filename);
+    void Open(const std::string& filename);
+
+    /**
+     * @brief Starts lexing an in-memory buffer, discarding the current input.
+     *
+     * The buffer is not copied, so it must outlive the lexing.
+     *
+     * @param text Input text.
+     */
+    void Reset(std::string_view text);
 
     /**
      * @brief Retrieves the next token from the token vector.
      *
-     * @return std::string The next token in the sequence; returns an empty
-     * string if the end of the line (EOL) is reached.
+     * @return symbol_id The ID of the next token in the sequence; returns
+     * `symbol_table::kNone` once every token has been consumed.
+     *
+     * This function allows sequential access to tokens processed by the lexer,
+     * reading new chunks of the input as needed.
+     *
+     * @throws LexerError If an invalid token is encountered.
+     */
+    symbol_id Next();
+
+    /**
+     * @brief Tokenizes the next chunk of the input.
+     *
+     * Tokens not yet returned by `Next()` are discarded.
+     *
+     * @return The token IDs of the chunk, valid until the next call to
+     * `NextChunk` or `Next`. It is empty once the input is exhausted.
      *
-     * This function allows sequential access to tokens processed by the lexer.
+     * @throws LexerError If an invalid token is encountered.
      */
-    std::string Next();
+    std::span<const symbol_id> NextChunk();
+
+    /**
+     * @brief Tokenizes the next bytes of an input pushed by the caller
+     * instead of read by the lexer, after `Reset` with no text.
+     *
+     * As with `NextChunk`, the last token, which more bytes could make
+     * longer, is held back unless the input ends: the caller passes it again
+     * in front of the next bytes.
+     *
+     * @param text Bytes held back by the last call followed by new ones.
+     * @param final Whether the input ends with `text`.
+     * @param size Set to the number of bytes of `text` tokenized; the rest
+     * is held back.
+     * @return The token IDs of `text`, valid until the next call; their
+     * ranges are given by `Ranges`.
+     *
+     * @throws LexerError If an invalid token is encountered, or a token
+     * longer than `kMaxTokenSize`.
+     */
+    std::span<const symbol_id> Feed(std::string_view text, bool final,
+                                    std::size_t& size);
+
+    /**
+     * @brief Enables or disables tracking the byte range of every token,
+     * returned by `Ranges`. It is disabled by default.
+     */
+    void TrackRanges(bool track) { track_ranges_ = track; }
+
+    /**
+     * @brief Byte ranges in the input of the tokens of the last chunk,
+     * parallel to them. Empty unless `TrackRanges` was enabled.
+     */
+    std::span<const token_range> Ranges() const { return ranges_; }
+
+    /// @brief Number of bytes of input tokenized at a time.
+    static constexpr std::size_t kChunkSize{1 << 16};
+
+    /// @brief Length of the longest token accepted, which bounds the bytes
+    /// held back between chunks.
+    static constexpr std::size_t kMaxTokenSize{1 << 20};
 
   private:
+
     /**
-     * @brief Tokenizes the input file using Boost Spirit Lex.
+     * @brief Tokenizes a chunk of input using Boost Spirit Lex.
+     *
+     * The resulting tokens are appended to `tokens_`. Unless the chunk is
+     * the end of the input, its last token, or the invalid bytes that stop
+     * the lexer, may be the start of a longer lexeme: they are left out, to
+     * be lexed again with the next bytes.
      *
-     * This function reads the content of the file specified by `filename_`,
-     * tokenizes it using Boost Spirit Lex, and stores the resulting tokens in
-     * the `tokens_` member variable. If the tokenization process encounters an
-     * invalid token, a `LexerError` is thrown with an error message indicating
-     * the invalid token.
+     * @param chunk Text to tokenize.
+     * @param final Whether the input ends with `chunk`.
+     * @return Number of bytes of `chunk` tokenized, the start of the next
+     * chunk.
      *
      * @throws LexerError If an invalid token is encountered during
-     * tokenization.
-     *
-     * @details The function performs the following steps:
-     * 1. Opens the file specified by `filename_` and reads its content into a
-     * string.
-     * 2. Converts the string into a C-style string (char array) for processing.
-     * 3. Uses Boost Spirit Lex to tokenize the input string.
-     * 4. If tokenization is successful, the tokens are stored in the `tokens_`
-     * member variable.
-     * 5. If tokenization fails (e.g., due to an invalid token), a `LexerError`
-     * is thrown.
-     *
-     * @note The function relies on the `parse_input` functor and the `add`
+     * tokenization, or a token longer than `kMaxTokenSize`.
+     *
+     * @note The function relies on the `ParseInput` functor and the `Add`
      * function to handle the tokenization and token storage, respectively.
      *
      * @see LexerError
      * @see tokens_
-     * @see filename_
      */
-    void Tokenize();
+    std::size_t Tokenize(std::string_view chunk, bool final);
+
+    /**
+     * @brief Next chunk of input text: the bytes held back by the last
+     * chunk followed by up to `kChunkSize` new ones, from the file if one is
+     * open or from the buffer otherwise.
+     *
+     * @param final Set to whether the input ends with the chunk.
+     * @return The chunk, empty once the input is exhausted. It stays valid
+     * until `Consume` is called.
+     */
+    std::string_view NextText(bool& final);
+
+    /**
+     * @brief Drops the bytes of the current chunk that were tokenized.
+     *
+     * @param size Number of bytes tokenized.
+     * @param chunk_size Size of the chunk; the rest is held back.
+     */
+    void Consume(std::size_t size, std::size_t chunk_size);
+
+    /// @brief Symbol table of the grammar being recognized.
+    const symbol_table& st_;
+
+    /// @brief Token definitions, built once and reused for every chunk.
+    ParseInput<boost::spirit::lex::lexertl::lexer<>> lexer_;
+
+    /// @brief Input file, read `kChunkSize` bytes at a time.
+    std::ifstream file_;
+
+    /// @brief Bytes read from `file_` and not tokenized yet.
+    std::string buffer_;
+
+    /// @brief Number of bytes held back by the last chunk.
+    std::size_t held_{0};
+
+    /// @brief Part of the in-memory input not tokenized yet.
+    std::string_view text_;
+
+    /// @brief Tokens of the current chunk.
+    std::vector<symbol_id> tokens_;
+
+    /// @brief Byte range of each token of `tokens_`, if `track_ranges_`.
+    std::vector<token_range> ranges_;
+
+    /// @brief Whether `ranges_` is filled.
+    bool track_ranges_{false};
+
+    /// @brief Offset in the input of the next chunk to tokenize.
+    std::size_t offset_{0};
+
+    /// @brief Position of the next token of `tokens_` returned by `Next()`.
+    std::size_t current_{0};
 };
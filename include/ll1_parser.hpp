@@ -1,35 +1,51 @@
 #pragma once
 #include "grammar.hpp"
-#include <deque>
+#include "symbol_table.hpp"
+#include "terminal_set.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <queue>
 #include <span>
-#include <stack>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
+/**
+ * @brief LL(1) table compiled from a grammar.
+ *
+ * Everything is computed at construction and never changes afterwards, so one
+ * parser can be shared read-only by any number of `ParseSession`s, including
+ * from several threads.
+ */
 class LL1Parser {
-    using ll1_table = std::unordered_map<
-        std::string, std::unordered_map<std::string, std::vector<production>>>;
-
-  public:
     /**
-     * @brief Constructs an LL1Parser with a grammar object and an input file.
+     * @brief Cell of the LL(1) table.
      *
-     * @param gr Grammar object to parse with.
-     * @param text_file Name of the file containing input to parse.
+     * Holds the index of the predicted production in the grammar, or
+     * `Grammar::kNoProduction` if the cell is empty. `conflict` is set when
+     * more than one production was predicted; the full list is then kept in
+     * `conflicts_`.
      */
-    LL1Parser(Grammar gr, std::string text_file, bool table_format = true);
+    struct ll1_cell {
+        std::uint32_t production : 31 {Grammar::kNoProduction};
+        std::uint32_t conflict : 1 {0};
+    };
+
+    /// @brief Dense LL(1) table, one row per non-terminal and one column per
+    /// terminal, stored row-major.
+    using ll1_table = std::vector<ll1_cell>;
+
+    /// @brief Productions of each conflicting cell, keyed by cell index.
+    using conflict_map =
+        std::unordered_map<std::size_t, std::vector<std::uint32_t>>;
 
+  public:
     /**
-     * @brief Constructs an LL1Parser with a grammar file and an input file.
+     * @brief Constructs an LL1Parser with a grammar object.
      *
-     * @param grammar_file Path to the grammar file.
-     * @param text_file Name of the file containing input to parse.
+     * @param gr Grammar object to parse with.
      */
-    LL1Parser(const std::string& grammar_file, std::string text_file,
-              bool table_format = true);
+    explicit LL1Parser(Grammar gr, bool table_format = true);
 
     /**
      * @brief Constructs an LL1Parser with a grammar file.
@@ -39,75 +55,50 @@ class LL1Parser {
     explicit LL1Parser(const std::string& grammar_file,
                        bool               table_format = true);
 
+    /// @brief Grammar the table was built for.
+    const Grammar& GetGrammar() const { return gr_; }
+
     /**
-     * @brief Parses an input string or file using the LL(1) parsing algorithm.
+     * @brief Production predicted by the LL(1) table.
      *
-     * This function performs syntactic analysis on the input based on the LL(1)
-     * parsing table, working to validate whether the input string conforms to
-     * the grammar. The parsing process involves a stack-based approach, where:
-     *
-     * - The function initializes a stack with the starting symbol of the
-     * grammar.
-     * - For each symbol in the input, it matches and expands according to the
-     *   entries in the LL(1) parsing table.
-     * - If a match is found for the current input symbol and top of the stack,
-     *   the function advances in the input and continues parsing.
-     * - If a production rule applies, it expands the non-terminal on the stack
-     *   using the rule.
-     * - If an unexpected symbol or parsing conflict arises, the function
-     * returns `false`, indicating that the input does not conform to the
-     * grammar.
-     *
-     * The function returns `true` if parsing completes successfully, reaching
-     * the end of the input and stack without errors. Otherwise, it returns
-     * `false`.
-     *
-     * @return `true` if the input is parsed successfully, meaning it conforms
-     * to the LL(1) grammar; `false` if parsing fails due to a mismatch,
-     * conflict, or unexpected input symbol.
+     * @param non_terminal Non-terminal symbol ID (table row).
+     * @param terminal Terminal symbol ID (table column).
+     * @return Index of the production, or `Grammar::kNoProduction` if the
+     * cell is empty.
      */
-    bool Parse();
+    std::uint32_t Prediction(symbol_id non_terminal, symbol_id terminal) const {
+        return ll1_t_[CellIndex(non_terminal, terminal)].production;
+    }
 
     /**
-     * @brief Matches a terminal symbol from the stack with the current input
-     * symbol.
-     *
-     * This function compares the terminal symbol at the top of the stack with
-     * the current input symbol. If they match, it updates the parsing trace
-     * (`trace_`), consumes the current input symbol, and retrieves the next
-     * input symbol using the lexical analyzer (`lex`).
-     *
-     * @param top_symbol The terminal symbol popped from the top of the stack.
-     * @param current_symbol The current input symbol to be matched.
-     * @return true if the terminal symbol matches the current input symbol,
-     * false otherwise.
+     * @brief Symbols to push onto the parse stack when a production is
+     * predicted, in push order.
+     *
+     * @param p Production index.
      */
-    bool MatchTerminal(const std::string& top_symbol,
-                       const std::string& current_symbol);
+    std::span<const symbol_id> PushSequence(std::uint32_t p) const {
+        return {push_symbols_.data() + push_offsets_[p],
+                push_symbols_.data() + push_offsets_[p + 1]};
+    }
 
     /**
-     * @brief Processes a non-terminal symbol by expanding it according to the
-     * LL(1) parsing table.
-     *
-     * This function looks up the production rule in the LL(1) parsing table
-     * (`ll1_t_`) for the given non-terminal symbol and current input symbol. If
-     * a matching production is found, the production's symbols are pushed onto
-     * the stack in reverse order.
+     * @brief Computes the FOLLOW set for a given non-terminal symbol in the
+     * grammar.
      *
-     * If no matching production is found, it checks whether the grammar allows
-     * an empty production for the non-terminal.
+     * The FOLLOW set for a non-terminal symbol includes all symbols that can
+     * appear immediately to the right of that symbol in any derivation, as well
+     * as any end-of-input markers if the symbol can appear at the end of
+     * derivations. FOLLOW sets are used in LL(1) parsing table construction to
+     * determine possible continuations after a non-terminal, and by
+     * `ParseSession` to resynchronize after a syntax error.
      *
-     * @param top_symbol The non-terminal symbol popped from the top of the
-     * stack.
-     * @param current_symbol The current input symbol used to select a
-     * production.
+     * @note This function assumes that the follow sets for all symbols have
+     * already been computed by using ComputeFollowSets function.
      *
-     * @return true if a production was successfully applied or an empty
-     * production exists, false if no valid production exists for the current
-     * input.
+     * @param arg Non-terminal symbol for which to compute the FOLLOW set.
+     * @return The terminal set that forms the FOLLOW set for `arg`.
      */
-    bool ProcessNonTerminal(const std::string& top_symbol,
-                            const std::string& current_symbol);
+    const TerminalSet& Follow(symbol_id arg) const;
 
     /**
      * @brief Print the LL(1) parsing table to standard output.
@@ -119,67 +110,55 @@ class LL1Parser {
      * - If `print_table_format_` is `false`, the table is printed in a simpler
      *   text format.
      */
-    void PrintTable();
-
-    /**
-     * @brief Prints the remaining symbols in the parsing stack after the
-     * parsing process.
-     *
-     * This function outputs the contents of the parsing stack to standard
-     * output after the parsing attempt completes, showing any symbols left
-     * unresolved. It is useful for debugging and tracing parsing issues, as it
-     * provides insight into where the parsing process may have diverged from
-     * expected behavior.
-     */
-    void PrintStackTrace();
+    void PrintTable() const;
 
+  private:
     /**
-     * @brief Prints the last kTraceSize symbols processed.
-     *
-     * Primarily used to identify the most recent tokens processed in case
-     * of parsing errors.
+     * @brief Computes the FIRST set of every suffix of every production.
+     *
+     * The FIRST set of a sequence of symbols contains all terminal symbols
+     * that can appear at the beginning of any string derived from it. If the
+     * sequence can derive the empty string (epsilon), epsilon is included in
+     * the FIRST set.
+     *
+     * After the FIRST sets of the non-terminals are known, this function
+     * walks each production right to left, so that the FIRST set of the
+     * suffix starting at position `i` comes from the one at `i + 1`:
+     * - If a terminal symbol is encountered, the FIRST set is that terminal.
+     * - If a non-terminal symbol is encountered, the FIRST set is its FIRST
+     * set without epsilon, plus the FIRST set of the next suffix if the
+     * non-terminal is nullable.
+     * - The EPSILON symbol does not change the FIRST set of the next suffix,
+     * and the empty suffix has FIRST set { epsilon }.
+     *
+     * The sets are stored in `suffix_first_`, so FOLLOW, prediction and
+     * conflict diagnostics read them instead of recomputing them.
      */
-    void PrintSymbolHist();
+    void ComputeSuffixFirstSets();
 
-  private:
     /**
-     * @brief Calculates the FIRST set for a given production rule in a grammar.
+     * @brief FIRST set of the right-hand side of a production from a given
+     * position on.
      *
-     * The FIRST set of a production rule contains all terminal symbols that can
-     * appear at the beginning of any string derived from that rule. If the rule
-     * can derive the empty string (epsilon), epsilon is included in the FIRST
-     * set.
-     *
-     * This function computes the FIRST set by examining each symbol in the
-     * production rule:
-     * - If a terminal symbol is encountered, it is added directly to the FIRST
-     * set, as it is the starting symbol of some derivation.
-     * - If a non-terminal symbol is encountered, its FIRST set is recursively
-     * computed and added to the result, excluding epsilon unless it is followed
-     * by another symbol that could also lead to epsilon.
-     * - If the entire rule could derive epsilon (i.e., each symbol in the rule
-     * can derive epsilon), then epsilon is added to the FIRST set.
-     *
-     * @param rule A span of strings representing the production rule for which
-     * to compute the FIRST set. Each string in the span is a symbol (either
-     * terminal or non-terminal).
-     * @param result A reference to an unordered set of strings where the
-     * computed FIRST set will be stored. The set will contain all terminal
-     * symbols that can start derivations of the rule, and possibly epsilon if
-     * the rule can derive an empty string.
+     * @param p Production index.
+     * @param i Position in the right-hand side. It may be its size, which
+     * stands for the empty suffix.
+     * @return The precomputed FIRST set of the suffix.
      */
-    void First(std::span<const std::string>     rule,
-               std::unordered_set<std::string>& result);
+    const TerminalSet& SuffixFirst(std::uint32_t p, size_t i) const;
 
     /**
      * @brief Computes the FIRST sets for all non-terminal symbols in the
      * grammar.
      *
      * This function calculates the FIRST set for each non-terminal symbol in
-     * the grammar by iteratively applying a least fixed-point algorithm. This
-     * approach ensures that the FIRST sets are fully populated by repeatedly
-     * expanding and updating the sets until no further changes occur (i.e., a
-     * fixed-point is reached).
+     * the grammar with a worklist algorithm. Since nullability is known in
+     * advance, each production `A -> X1 ... Xn` contributes the terminal that
+     * starts it, if any, and an edge `Xi -> A` for every non-terminal `Xi`
+     * reachable through nullable symbols. Those terminals seed the sets, and
+     * a non-terminal is revisited only when the FIRST set of one of the
+     * symbols it depends on grows, which is near-linear in the size of the
+     * grammar.
      */
     void ComputeFirstSets();
 
@@ -197,17 +176,22 @@ class LL1Parser {
      * 1. Initialize FOLLOW(S) = { $ }, where S is the start symbol.
      * 2. For each production rule of the form A → αBβ:
      *    - Add FIRST(β) (excluding ε) to FOLLOW(B).
-     *    - If ε ∈ FIRST(β), add FOLLOW(A) to FOLLOW(B).
-     * 3. Repeat step 2 until no changes occur in any FOLLOW set.
+     *    - If ε ∈ FIRST(β), record the inclusion FOLLOW(B) ⊇ FOLLOW(A).
+     * 3. Propagate the sets along the inclusion digraph with the DeRemer and
+     *    Pennello traversal: strongly connected components are detected on
+     *    the fly, every member of a component gets the same set, and each
+     *    set is final when its component is closed. Each edge is followed
+     *    once, so the whole computation is linear in the size of the grammar
+     *    (times the bitset width).
      *
      * The computed FOLLOW sets are cached in the `follow_sets_` member variable
      * for later use by the parser.
      *
-     * @note This function assumes that the FIRST sets for all symbols have
-     * already been computed and are available in the `first_sets_` member
-     * variable.
+     * @note This function assumes that the FIRST sets of all production
+     * suffixes have already been computed and are available in the
+     * `suffix_first_` member variable.
      *
-     * @see First
+     * @see SuffixFirst
      * @see follow_sets_
      */
     void ComputeFollowSets();
@@ -215,41 +199,19 @@ class LL1Parser {
     /**
      * @brief Updates the FOLLOW set for a non-terminal based on a production.
      *
-     * This method updates the FOLLOW set of a given non-terminal symbol based
-     * on its position within a production. It considers:
-     * - The FIRST set of the remaining symbols after the current non-terminal.
-     * - The FOLLOW set of the left-hand side non-terminal, if the remaining
-     * symbols can derive ε.
+     * This method adds to the FOLLOW set of a given non-terminal symbol the
+     * FIRST set of the remaining symbols after it in a production (excluding
+     * ε). The contribution of the FOLLOW set of the left-hand side
+     * non-terminal is left to the caller.
      *
      * @param symbol The non-terminal symbol whose FOLLOW set is being updated.
-     * @param lhs The left-hand side non-terminal of the current production.
-     * @param rhs The production (right-hand side) containing the symbol.
+     * @param p The production containing the symbol.
      * @param i The position of the symbol within the production.
      *
-     * @return true if the FOLLOW set was modified (new elements were added),
-     * false otherwise.
+     * @return true if the remaining symbols can derive ε, so the FOLLOW set
+     * of the left-hand side must be included in the FOLLOW set of `symbol`.
      */
-    bool UpdateFollow(const std::string& symbol, const std::string& lhs,
-                      const production& rhs, size_t i);
-
-    /**
-     * @brief Computes the FOLLOW set for a given non-terminal symbol in the
-     * grammar.
-     *
-     * The FOLLOW set for a non-terminal symbol includes all symbols that can
-     * appear immediately to the right of that symbol in any derivation, as well
-     * as any end-of-input markers if the symbol can appear at the end of
-     * derivations. FOLLOW sets are used in LL(1) parsing table construction to
-     * determine possible continuations after a non-terminal.
-     *
-     * @note This function assumes that the follow sets for all symbols have
-     * already been computed by using ComputeFollowSets function.
-     *
-     * @param arg Non-terminal symbol for which to compute the FOLLOW set.
-     * @return An unordered set of strings containing symbols that form the
-     * FOLLOW set for `arg`.
-     */
-    std::unordered_set<std::string> Follow(const std::string& arg);
+    bool UpdateFollow(symbol_id symbol, std::uint32_t p, size_t i);
 
     /**
      * @brief Computes the prediction symbols for a given
@@ -267,15 +229,11 @@ class LL1Parser {
      * symbols are computed as (FIRST(consequent) - {epsilon}) ∪
      * FOLLOW(antecedent).
      *
-     * @param antecedent The left-hand side non-terminal symbol of the rule.
-     * @param consequent A vector of symbols on the right-hand side of the rule
-     * (production body).
-     * @return An unordered set of strings containing the prediction symbols for
-     * the specified rule.
+     * @param p Index of the production rule.
+     * @return A terminal set containing the prediction symbols for the
+     * specified rule.
      */
-    std::unordered_set<std::string>
-    PredictionSymbols(const std::string&              antecedent,
-                      const std::vector<std::string>& consequent);
+    TerminalSet PredictionSymbols(std::uint32_t p) const;
 
     /**
      * @brief Creates the LL(1) parsing table for the grammar.
@@ -291,15 +249,70 @@ class LL1Parser {
      * symbols using the `director_symbols` function.
      * - It then fills the parsing table at the cell corresponding to the
      * non-terminal `A` and each director symbol in the set.
-     * - If a cell already contains a production, this indicates a conflict,
+     * - If the prediction symbols of a production intersect those of another
+     * production of the same non-terminal, this indicates a conflict,
      * meaning the grammar is not LL(1).
      *
+     * Once FIRST and FOLLOW sets are known the rows are independent, so they
+     * are split in contiguous blocks run on a `WorkStealingPool` started for
+     * the build, at most one thread per block (see `FillRows`). Builds on
+     * different threads thus never wait on each other, and no thread outlives
+     * the build. Each block writes its own rows of `ll1_t_` and collects its
+     * own conflicts, which are merged into `conflicts_` at the end.
+     *
      * @return `true` if the table is created successfully, indicating the
      * grammar is LL(1) compatible; `false` if any conflicts are detected,
      * showing that the grammar does not meet LL(1) requirements.
      */
     bool CreateLL1Table();
 
+    /**
+     * @brief Fills the LL(1) table rows of a range of non-terminals.
+     *
+     * Only the cells of rows `[first, last)` are written, so disjoint ranges
+     * can be filled concurrently.
+     *
+     * @param first First non-terminal of the range.
+     * @param last Non-terminal past the end of the range.
+     * @param conflicts Map where the conflicting cells of the range are
+     * recorded.
+     * @return `true` if no conflict was found in the range.
+     */
+    bool FillRows(symbol_id first, symbol_id last, conflict_map& conflicts);
+
+    /**
+     * @brief Precompiles the push sequence of every production.
+     *
+     * The push sequence is the right-hand side reversed and without EPSILON
+     * symbols, so predicting a production is a single bulk copy onto the
+     * parse stack and EPSILON never reaches it.
+     */
+    void CompilePushSequences();
+
+    /**
+     * @brief Index of the LL(1) table cell for a non-terminal and a terminal.
+     *
+     * @param non_terminal Non-terminal symbol ID (table row).
+     * @param terminal Terminal symbol ID (table column).
+     * @return Position of the cell in `ll1_t_`.
+     */
+    std::size_t CellIndex(symbol_id non_terminal, symbol_id terminal) const {
+        return static_cast<std::size_t>(non_terminal - gr_.st_.NumTerminals()) *
+                   gr_.st_.NumTerminals() +
+               terminal;
+    }
+
+    /**
+     * @brief Productions stored in an LL(1) table cell.
+     *
+     * @param non_terminal Non-terminal symbol ID (table row).
+     * @param terminal Terminal symbol ID (table column).
+     * @return Index of every production predicted for the cell, more than one
+     * if the cell has a conflict, or none if the cell is empty.
+     */
+    std::vector<std::uint32_t> CellProductions(symbol_id non_terminal,
+                                               symbol_id terminal) const;
+
     /**
      * @brief Print the LL(1) parsing table using the tabulate library.
      *
@@ -312,38 +325,50 @@ class LL1Parser {
      * - Red font color for cells containing multiple productions (conflicts).
      * - A visually structured alignment for improved readability.
      */
-    void PrintTableUsingTabulate();
+    void PrintTableUsingTabulate() const;
 
-    /// @brief Size limit for symbol history trace, defaults to 5.
-    const size_t kTraceSize{5};
+    /// @brief Fewest table rows worth a task of their own on the thread pool
+    /// when building the LL(1) table.
+    static constexpr std::size_t kMinRowsPerTask{64};
 
     /// @brief The LL(1) parsing table, mapping non-terminals and terminals to
     /// productions.
     ll1_table ll1_t_;
 
+    /// @brief Every production index predicted by a conflicting cell, keyed by
+    /// cell index. Only used to report conflicts.
+    conflict_map conflicts_;
+
     /// @brief Grammar object associated with this parser.
     Grammar gr_;
 
-    /// @brief FIRST sets for each non-terminal in the grammar.
-    std::unordered_map<std::string, std::unordered_set<std::string>>
-        first_sets_;
+    /// @brief FIRST sets for each non-terminal in the grammar, indexed by
+    /// `symbol_table::NonTerminalIndex`. The epsilon bit marks nullability.
+    std::vector<TerminalSet> first_sets_;
+
+    /// @brief FOLLOW sets for each non-terminal in the grammar, indexed by
+    /// `symbol_table::NonTerminalIndex`.
+    std::vector<TerminalSet> follow_sets_;
 
-    /// @brief FOLLOW sets for each non-terminal in the grammar.
-    std::unordered_map<std::string, std::unordered_set<std::string>>
-        follow_sets_;
+    /// @brief FIRST set of each production suffix, parallel to
+    /// `Grammar::rhs_`: entry `k` is the FIRST set of the symbols from `k` to
+    /// the end of their production.
+    std::vector<TerminalSet> suffix_first_;
 
-    /// @brief Stack for managing parsing symbols.
-    std::stack<std::string> symbol_stack_;
+    /// @brief FIRST set of the empty suffix, { epsilon }.
+    TerminalSet empty_suffix_first_;
 
-    /// @brief Deque for tracking the most recent kTraceSize symbols parsed.
-    std::deque<std::string> trace_;
+    /// @brief Push sequence of every production, stored back to back. Those of
+    /// production `p` are `[push_offsets_[p], push_offsets_[p + 1])`.
+    std::vector<symbol_id> push_symbols_;
+
+    /// @brief Start of each production's push sequence in `push_symbols_`,
+    /// plus a final end offset.
+    std::vector<std::uint32_t> push_offsets_{0};
 
     /// @brief Path to the grammar file used in this parser.
     std::string grammar_file_;
 
-    /// @brief Path to the input text file to be parsed.
-    std::string text_file_;
-
     /// @brief True if new format is used when printing the table
     bool print_table_format_{true};
 };
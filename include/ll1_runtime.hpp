@@ -0,0 +1,170 @@
+#pragma once
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Tables of a grammar exported by `ll1 --emit-header`.
+ *
+ * Every member is a `static constexpr` array or constant, so a parser
+ * instantiated with them reads the table straight from read-only data, and
+ * lookups with constant arguments fold at compile time.
+ */
+template <typename T>
+concept ll1_tables = requires {
+    { T::kNumTerminals } -> std::convertible_to<std::uint32_t>;
+    { T::kNumSymbols } -> std::convertible_to<std::uint32_t>;
+    { T::kNumProductions } -> std::convertible_to<std::uint32_t>;
+    { T::kAxiom } -> std::convertible_to<std::uint32_t>;
+    { T::kNoProduction } -> std::convertible_to<std::uint32_t>;
+    T::kRhs[0];
+    T::kProdOffsets[0];
+    T::kTable[0];
+    T::kEmptyProduction[0];
+};
+
+/**
+ * @brief Push sequence of every production of an exported grammar, derived
+ * from its right-hand sides at compile time.
+ *
+ * Same layout as `LL1Parser::PushSequence`: the symbols of each right-hand
+ * side in reverse order, EPSILON excluded.
+ */
+template <ll1_tables Tables> struct push_sequences {
+    /// @brief ID of EPSILON, the same in every grammar.
+    static constexpr std::uint32_t kEpsilon{0};
+
+    /// @brief Offset of each production in `kSymbols`, plus the end.
+    static constexpr auto kOffsets = [] {
+        std::array<std::uint32_t, Tables::kNumProductions + 1> offsets{};
+        for (std::uint32_t p = 0; p < Tables::kNumProductions; ++p) {
+            offsets[p + 1] = offsets[p];
+            for (std::uint32_t i = Tables::kProdOffsets[p];
+                 i < Tables::kProdOffsets[p + 1]; ++i) {
+                offsets[p + 1] += Tables::kRhs[i] != kEpsilon ? 1 : 0;
+            }
+        }
+        return offsets;
+    }();
+
+    /// @brief Symbols of every push sequence, concatenated.
+    static constexpr auto kSymbols = [] {
+        std::array<std::uint32_t, std::size(Tables::kRhs)> symbols{};
+        std::size_t                                       n{0};
+        for (std::uint32_t p = 0; p < Tables::kNumProductions; ++p) {
+            for (std::uint32_t i = Tables::kProdOffsets[p + 1];
+                 i > Tables::kProdOffsets[p]; --i) {
+                if (Tables::kRhs[i - 1] != kEpsilon) {
+                    symbols[n++] = Tables::kRhs[i - 1];
+                }
+            }
+        }
+        return symbols;
+    }();
+};
+
+/**
+ * @brief LL(1) parser over the tables of an exported grammar.
+ *
+ * Same algorithm and results as `ParseSession`, with no grammar file to read
+ * and no table to build: everything it reads is a compile-time constant of
+ * `Tables`. The input is a sequence of token IDs, the `terminal` enumerators
+ * of the exported header, and can be fed in several pieces.
+ *
+ * @tparam Tables Struct generated by `ll1 --emit-header`.
+ */
+template <ll1_tables Tables> class TableParser {
+  public:
+    /// @brief State of a parse after feeding it some tokens.
+    enum parse_status {
+        RUNNING,  ///< Every token was consumed, more may follow.
+        ACCEPTED, ///< The stack emptied, the input is accepted.
+        REJECTED  ///< A token did not match, the input is rejected.
+    };
+
+    constexpr TableParser() { Reset(); }
+
+    /// @brief Starts a new parse.
+    constexpr void Reset() {
+        stack_.clear();
+        stack_.push_back(Tables::kAxiom);
+        status_ = RUNNING;
+    }
+
+    /**
+     * @brief Production predicted by the LL(1) table.
+     *
+     * @param non_terminal Non-terminal symbol ID (table row).
+     * @param terminal Terminal symbol ID (table column).
+     * @return Index of the production, or `Tables::kNoProduction`.
+     */
+    static constexpr std::uint32_t Prediction(std::uint32_t non_terminal,
+                                              std::uint32_t terminal) {
+        return Tables::kTable[(non_terminal - Tables::kNumTerminals) *
+                                  Tables::kNumTerminals +
+                              terminal];
+    }
+
+    /**
+     * @brief Runs the parse over the next tokens of the input.
+     *
+     * @param tokens Next token IDs of the input, in order.
+     * @return `RUNNING` if every token was consumed, `ACCEPTED` if the stack
+     * emptied and `REJECTED` if the input does not conform to the grammar.
+     */
+    constexpr parse_status Feed(std::span<const std::uint32_t> tokens) {
+        using sequences = push_sequences<Tables>;
+        for (std::size_t pos = 0; status_ == RUNNING && pos < tokens.size();) {
+            if (stack_.empty()) {
+                status_ = ACCEPTED;
+                break;
+            }
+            std::uint32_t top_symbol = stack_.back();
+            stack_.pop_back();
+            if (top_symbol < Tables::kNumTerminals) {
+                if (top_symbol != tokens[pos++]) {
+                    status_ = REJECTED;
+                }
+                continue;
+            }
+            std::uint32_t production = Prediction(top_symbol, tokens[pos]);
+            if (production != Tables::kNoProduction) {
+                const std::uint32_t* symbols = sequences::kSymbols.data();
+                stack_.insert(stack_.end(),
+                              symbols + sequences::kOffsets[production],
+                              symbols + sequences::kOffsets[production + 1]);
+            } else if (Tables::kEmptyProduction[top_symbol -
+                                                Tables::kNumTerminals] ==
+                       Tables::kNoProduction) {
+                status_ = REJECTED;
+            }
+        }
+        return status_;
+    }
+
+    /// @brief Whether the input fed so far conforms to the grammar.
+    constexpr bool Accepted() const { return status_ != REJECTED; }
+
+    /**
+     * @brief Parses a whole input.
+     *
+     * @param tokens Token IDs of the input, in order.
+     * @return `true` if the input is accepted, `false` otherwise.
+     */
+    static constexpr bool Parse(std::span<const std::uint32_t> tokens) {
+        TableParser parser;
+        parser.Feed(tokens);
+        return parser.Accepted();
+    }
+
+  private:
+    /// @brief Parse stack, its top is the last element.
+    std::vector<std::uint32_t> stack_;
+
+    /// @brief State of the parse.
+    parse_status status_{RUNNING};
+};
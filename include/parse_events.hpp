@@ -0,0 +1,61 @@
+#pragma once
+#include "lexer.hpp"
+#include "symbol_table.hpp"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Receiver of the events of a parse, see
+ * `ParseSession::ParseFile(const std::string&, Visitor&)`.
+ *
+ * The events follow the LL(1) derivation in order, like a depth-first walk of
+ * the concrete syntax tree that is never built:
+ *
+ * - `EnterNonTerminal(non_terminal, production, num_children, begin)` when a
+ *   non-terminal is expanded with `production`. It derives `num_children`
+ *   symbols, EPSILON excluded, 0 when it is expanded with its empty
+ *   production. `begin` is the offset of the first byte it derives.
+ * - `ShiftTerminal(terminal, range)` when a token is matched, with its byte
+ *   range in the input.
+ * - `ExitNonTerminal(non_terminal, end)` once every symbol it derives is
+ *   done, with the offset past its last byte.
+ *
+ * The visitor is a template parameter of the parse loop, so the calls are
+ * resolved at compile time and can be inlined. If the input ends before the
+ * stack empties, the symbols still pending get no events and the
+ * non-terminals still open are exited.
+ */
+template <typename V>
+concept parse_visitor = requires(V& visitor, symbol_id symbol,
+                                 std::uint32_t production, std::size_t offset,
+                                 token_range range) {
+    visitor.EnterNonTerminal(symbol, production, offset, offset);
+    visitor.ExitNonTerminal(symbol, offset);
+    visitor.ShiftTerminal(symbol, range);
+};
+
+/**
+ * @brief Event of a parse as a value, for parsers that hand events out
+ * instead of calling a visitor, see `PushSession`. Same events and order as
+ * `parse_visitor`.
+ */
+struct parse_event {
+    /// @brief Which of the visitor calls the event stands for.
+    enum event_kind {
+        ENTER, ///< `EnterNonTerminal`.
+        SHIFT, ///< `ShiftTerminal`.
+        EXIT   ///< `ExitNonTerminal`.
+    };
+
+    event_kind kind;
+    /// @brief Non-terminal entered or exited, or terminal matched.
+    symbol_id symbol;
+    /// @brief Production a non-terminal is expanded with, for `ENTER`.
+    std::uint32_t production;
+    /// @brief Number of symbols derived, EPSILON excluded, for `ENTER`.
+    std::size_t num_children;
+    /// @brief Byte range of the token for `SHIFT`. Empty for `ENTER`, at the
+    /// begin offset, and for `EXIT`, at the end offset.
+    token_range range;
+};
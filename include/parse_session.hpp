@@ -0,0 +1,480 @@
+#pragma once
+#include "grammar.hpp"
+#include "lexer.hpp"
+#include "ll1_parser.hpp"
+#include "parse_events.hpp"
+#include "parse_tree.hpp"
+#include "symbol_history.hpp"
+#include "symbol_table.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief Syntax error found while parsing with recovery enabled.
+struct syntax_error {
+    /// @brief Byte offset in the input of the unexpected token.
+    std::size_t offset;
+    /// @brief Unexpected token.
+    symbol_id found;
+    /// @brief Symbol on top of the stack when the token was found.
+    symbol_id expected;
+};
+
+/**
+ * @brief State of the parses run against one `LL1Parser`.
+ *
+ * The session owns everything that changes while parsing: the parse stack,
+ * the symbol history and the lexer. The parser is only read, so several
+ * sessions, e.g. one per thread, can share it without copying the grammar or
+ * the table. A session can be reused for many inputs, every parse starts from
+ * an empty stack and history.
+ */
+class ParseSession {
+    /// @brief State of a parse after feeding it some tokens.
+    enum parse_status {
+        RUNNING,  ///< Every token was consumed, more may follow.
+        ACCEPTED, ///< The stack emptied, the input is accepted.
+        REJECTED  ///< A token did not match, the input is rejected.
+    };
+
+  public:
+    /// @brief Default number of processed symbols kept in the history.
+    static constexpr std::size_t kDefaultHistorySize{5};
+
+    /**
+     * @brief Constructs a session for a parser.
+     *
+     * @param parser Compiled grammar to parse with; it must outlive the
+     * session.
+     * @param history_size Number of processed symbols kept for
+     * `PrintSymbolHist`, 0 disables the history.
+     */
+    explicit ParseSession(const LL1Parser& parser,
+                          std::size_t      history_size = kDefaultHistorySize);
+
+    /**
+     * @brief Parses an input file using the LL(1) parsing algorithm.
+     *
+     * This function performs syntactic analysis on the input based on the LL(1)
+     * parsing table, working to validate whether the input string conforms to
+     * the grammar. The parsing process involves a stack-based approach, where:
+     *
+     * - The function initializes a stack with the starting symbol of the
+     * grammar.
+     * - For each symbol in the input, it matches and expands according to the
+     *   entries in the LL(1) parsing table.
+     * - If a match is found for the current input symbol and top of the stack,
+     *   the function advances in the input and continues parsing.
+     * - If a production rule applies, it expands the non-terminal on the stack
+     *   using the rule.
+     * - If an unexpected symbol or parsing conflict arises, the function
+     * returns `false`, indicating that the input does not conform to the
+     * grammar.
+     *
+     * The function returns `true` if parsing completes successfully, reaching
+     * the end of the input and stack without errors. Otherwise, it returns
+     * `false`.
+     *
+     * The input file is streamed: `Lex` tokenizes it one bounded chunk at a
+     * time and each chunk is fed to the parser before the next one is read,
+     * so memory use depends on the stack depth and not on the input size.
+     *
+     * @param filename Path to the input file.
+     * @return `true` if the input is parsed successfully, meaning it conforms
+     * to the LL(1) grammar; `false` if parsing fails due to a mismatch,
+     * conflict, or unexpected input symbol.
+     *
+     * @throws LexerError If the file cannot be opened or contains an invalid
+     * token.
+     */
+    bool ParseFile(const std::string& filename);
+
+    /**
+     * @brief Parses an input held in memory.
+     *
+     * Same as `ParseFile`, reading the input from a buffer instead of a file.
+     *
+     * @param text Input text.
+     * @return `true` if the input is accepted, `false` otherwise.
+     *
+     * @throws LexerError If the text contains an invalid token.
+     */
+    bool ParseText(std::string_view text);
+
+    /**
+     * @brief Parses an input file and builds its concrete syntax tree.
+     *
+     * Same as `ParseFile`, also recording the LL(1) derivation in `tree`:
+     * each predicted production becomes a node whose children are allocated
+     * in the tree arena, and each matched token a leaf with its byte range in
+     * the file. If the input ends before the stack empties, the symbols left
+     * on it become empty nodes.
+     *
+     * @param filename Path to the input file.
+     * @param tree Tree to build, cleared first. Its root is null if the input
+     * is rejected.
+     * @return `true` if the input is accepted, `false` otherwise.
+     *
+     * @throws LexerError If the file cannot be opened or contains an invalid
+     * token.
+     */
+    bool ParseFile(const std::string& filename, ParseTree& tree);
+
+    /**
+     * @brief Parses an input held in memory and builds its concrete syntax
+     * tree, see `ParseFile(const std::string&, ParseTree&)`.
+     *
+     * @param text Input text; node byte ranges are offsets into it.
+     * @param tree Tree to build, cleared first.
+     * @return `true` if the input is accepted, `false` otherwise.
+     *
+     * @throws LexerError If the text contains an invalid token.
+     */
+    bool ParseText(std::string_view text, ParseTree& tree);
+
+    /**
+     * @brief Parses an input file, reporting its derivation to a visitor.
+     *
+     * Same as `ParseFile`, also calling `visitor` for every non-terminal
+     * expanded and every token matched, see `parse_visitor`. Nothing is
+     * stored per node, so metrics or fields can be extracted from inputs of
+     * any size in a single streamed pass. The events fired before a
+     * rejection are not undone.
+     *
+     * @param filename Path to the input file.
+     * @param visitor Receiver of the events.
+     * @return `true` if the input is accepted, `false` otherwise.
+     *
+     * @throws LexerError If the file cannot be opened or contains an invalid
+     * token.
+     */
+    template <parse_visitor Visitor>
+    bool ParseFile(const std::string& filename, Visitor& visitor) {
+        lex_.Open(filename);
+        return ParseLexedEvents(visitor);
+    }
+
+    /**
+     * @brief Parses an input held in memory, reporting its derivation to a
+     * visitor, see `ParseFile(const std::string&, Visitor&)`.
+     *
+     * @param text Input text; event offsets are offsets into it.
+     * @param visitor Receiver of the events.
+     * @return `true` if the input is accepted, `false` otherwise.
+     *
+     * @throws LexerError If the text contains an invalid token.
+     */
+    template <parse_visitor Visitor>
+    bool ParseText(std::string_view text, Visitor& visitor) {
+        lex_.Reset(text);
+        return ParseLexedEvents(visitor);
+    }
+
+    /**
+     * @brief Parses a sequence of already lexed tokens.
+     *
+     * Same algorithm as `ParseFile`, run over a contiguous array of token IDs
+     * (terminal symbol IDs, as produced by `Lex`). The parse stack is a
+     * preallocated vector of symbol IDs, so the loop does not allocate per
+     * token: each step is a stack pop, a terminal comparison or a table load.
+     * The symbol history (`trace_`) is recorded from the tokens once parsing
+     * stops.
+     *
+     * @param tokens Token IDs of the input, in order.
+     * @return `true` if the tokens are accepted, `false` otherwise.
+     */
+    bool Parse(std::span<const symbol_id> tokens);
+
+    /**
+     * @brief Prints the remaining symbols in the parsing stack after the
+     * parsing process.
+     *
+     * This function outputs the contents of the parsing stack to standard
+     * output after the parsing attempt completes, showing any symbols left
+     * unresolved. It is useful for debugging and tracing parsing issues, as it
+     * provides insight into where the parsing process may have diverged from
+     * expected behavior.
+     */
+    void PrintStackTrace();
+
+    /**
+     * @brief Prints the last symbols processed, as many as the history size.
+     *
+     * Primarily used to identify the most recent tokens processed in case
+     * of parsing errors. Prints nothing if the history is disabled.
+     */
+    void PrintSymbolHist();
+
+    /**
+     * @brief Sets how many processed symbols are kept for
+     * `PrintSymbolHist`.
+     *
+     * @param size Number of symbols, 0 disables the history.
+     */
+    void SetHistorySize(std::size_t size);
+
+    /**
+     * @brief Enables panic-mode error recovery in `ParseFile` and
+     * `ParseText`.
+     *
+     * With recovery, a syntax error does not stop the parse: it is recorded
+     * in `Errors` and the parser resynchronizes, so every error of the input
+     * is found in a single pass. On a mismatched terminal, the terminal is
+     * taken as missing if the token can follow it on the stack, otherwise
+     * the token is skipped. On a non-terminal that cannot start with the
+     * token, the non-terminal is taken as missing if the token is in its
+     * FOLLOW set, otherwise the token is skipped. The end-of-line token is
+     * never skipped. Errors found before a token is matched again are
+     * consequences of the last one and are not recorded.
+     *
+     * Parses that build a tree or fire events always stop at the first
+     * error.
+     *
+     * @param recover `true` to enable recovery.
+     */
+    void SetRecovery(bool recover) { recover_ = recover; }
+
+    /// @brief Errors found by the last parse with recovery, in input order.
+    const std::vector<syntax_error>& Errors() const { return errors_; }
+
+    /**
+     * @brief Prints the errors found by the last parse with recovery, one per
+     * line, with the byte offset of the unexpected token and the expected
+     * symbols.
+     *
+     * @param out Stream to print to.
+     */
+    void PrintErrors(std::ostream& out) const;
+
+  private:
+    /**
+     * @brief Marks a stack entry as the end of the symbols derived by a
+     * non-terminal, the non-terminal being the other bits. Only pushed by
+     * `FeedEvents`.
+     */
+    static constexpr symbol_id kCloseBit{symbol_id{1} << 31};
+
+    /// @brief Resets the parse stack and history to start a new parse.
+    void StartParse();
+
+    /**
+     * @brief Parses the input loaded in `lex_`, feeding it to the parser one
+     * chunk at a time.
+     *
+     * @return `true` if the input is accepted, `false` otherwise.
+     */
+    bool ParseLexed();
+
+    /**
+     * @brief Same as `ParseLexed`, reporting the derivation to `visitor`.
+     */
+    template <parse_visitor Visitor> bool ParseLexedEvents(Visitor& visitor);
+
+    /**
+     * @brief Runs the parse over the next tokens of the input.
+     *
+     * The stack and history are kept between calls, so an input can be fed
+     * in several pieces.
+     *
+     * @param tokens Next token IDs of the input, in order.
+     * @return `RUNNING` if every token was consumed, `ACCEPTED` if the stack
+     * emptied and `REJECTED` if the input does not conform to the grammar.
+     */
+    parse_status Feed(std::span<const symbol_id> tokens);
+
+    /**
+     * @brief Same as `Feed`, also firing the events of the derivation: each
+     * expanded non-terminal leaves a `kCloseBit` entry below the symbols it
+     * derives, which exits it when popped.
+     *
+     * @param tokens Next token IDs of the input, in order.
+     * @param ranges Byte range of each token.
+     * @param visitor Receiver of the events.
+     */
+    template <parse_visitor Visitor>
+    parse_status FeedEvents(std::span<const symbol_id>   tokens,
+                            std::span<const token_range> ranges,
+                            Visitor&                     visitor);
+
+    /**
+     * @brief Exits the non-terminals still open when the input ends before
+     * the stack empties, without popping the stack.
+     */
+    template <parse_visitor Visitor> void FinishEvents(Visitor& visitor);
+
+    /**
+     * @brief Same as `Feed`, recovering from syntax errors instead of
+     * stopping, see `SetRecovery`.
+     *
+     * @param tokens Next token IDs of the input, in order.
+     * @param ranges Byte range of each token.
+     * @return `RUNNING` if every token was consumed, `ACCEPTED` if the stack
+     * emptied.
+     */
+    parse_status FeedRecovering(std::span<const symbol_id>   tokens,
+                                std::span<const token_range> ranges);
+
+    /**
+     * @brief Checks if a token can be matched right after popping the top of
+     * the stack, i.e. by the symbol below it.
+     */
+    bool MatchesBelowTop(symbol_id token) const;
+
+    /**
+     * @brief Records a syntax error unless the parser is still recovering
+     * from the previous one.
+     */
+    void ReportError(std::size_t offset, symbol_id found, symbol_id expected);
+
+    /// @brief Pops the begin offset of the innermost open non-terminal and
+    /// returns its end offset.
+    std::size_t CloseOffset() {
+        std::size_t begin = open_begins_.back();
+        open_begins_.pop_back();
+        return std::max(begin, last_end_);
+    }
+
+    /**
+     * @brief Processes a non-terminal symbol by expanding it according to the
+     * LL(1) parsing table.
+     *
+     * This function looks up the production rule in the LL(1) parsing table
+     * for the given non-terminal symbol and current input symbol, which is a
+     * single indexed load. If a matching production is found, its
+     * precompiled push sequence is copied onto the stack in one go.
+     *
+     * If no matching production is found, it checks whether the grammar allows
+     * an empty production for the non-terminal.
+     *
+     * @param top_symbol The non-terminal symbol popped from the top of the
+     * stack.
+     * @param current_symbol The current input symbol used to select a
+     * production.
+     *
+     * @return true if a production was successfully applied or an empty
+     * production exists, false if no valid production exists for the current
+     * input.
+     */
+    bool ProcessNonTerminal(symbol_id top_symbol, symbol_id current_symbol);
+
+    /// @brief Initial capacity of `symbol_stack_`, so that typical inputs never
+    /// grow it while parsing.
+    static constexpr std::size_t kInitialStackSize{1024};
+
+    /// @brief Compiled grammar shared with other sessions.
+    const LL1Parser& parser_;
+
+    /// @brief Grammar of `parser_`.
+    const Grammar& gr_;
+
+    /// @brief Stack for managing parsing symbols, its top is the last element.
+    std::vector<symbol_id> symbol_stack_;
+
+    /// @brief Begin offset of each non-terminal open in `FeedEvents`, the
+    /// innermost last.
+    std::vector<std::size_t> open_begins_;
+
+    /// @brief End offset of the last token matched in `FeedEvents`.
+    std::size_t last_end_{0};
+
+    /// @brief Whether `ParseFile` and `ParseText` recover from errors.
+    bool recover_{false};
+
+    /// @brief Set from a syntax error until the next token is matched.
+    bool recovering_{false};
+
+    /// @brief Errors found by the last parse with recovery.
+    std::vector<syntax_error> errors_;
+
+    /// @brief Most recent symbols parsed, kept as symbol IDs.
+    SymbolHistory trace_;
+
+    /// @brief Lexer for the grammar terminals, reused for every input.
+    Lex lex_;
+};
+
+template <parse_visitor Visitor>
+bool ParseSession::ParseLexedEvents(Visitor& visitor) {
+    StartParse();
+    lex_.TrackRanges(true);
+    open_begins_.clear();
+    last_end_ = 0;
+
+    parse_status status{RUNNING};
+    for (auto chunk = lex_.NextChunk(); status == RUNNING && !chunk.empty();
+         chunk      = lex_.NextChunk()) {
+        status = FeedEvents(chunk, lex_.Ranges(), visitor);
+    }
+    if (status != REJECTED) {
+        FinishEvents(visitor);
+    }
+    return status != REJECTED;
+}
+
+template <parse_visitor Visitor>
+ParseSession::parse_status
+ParseSession::FeedEvents(std::span<const symbol_id>   tokens,
+                         std::span<const token_range> ranges,
+                         Visitor&                     visitor) {
+    symbol_id    num_terminals{gr_.st_.NumTerminals()};
+    size_t       pos{0};
+    parse_status status{RUNNING};
+    while (pos < tokens.size()) {
+        if (symbol_stack_.empty()) {
+            status = ACCEPTED;
+            break;
+        }
+        symbol_id top_symbol = symbol_stack_.back();
+        symbol_stack_.pop_back();
+        if ((top_symbol & kCloseBit) != 0) {
+            visitor.ExitNonTerminal(top_symbol & ~kCloseBit, CloseOffset());
+            continue;
+        }
+
+        if (top_symbol < num_terminals) {
+            // The mismatched token counts as processed in the history
+            if (top_symbol != tokens[pos]) {
+                ++pos;
+                status = REJECTED;
+                break;
+            }
+            visitor.ShiftTerminal(top_symbol, ranges[pos]);
+            last_end_ = ranges[pos++].end;
+            continue;
+        }
+
+        std::uint32_t production = parser_.Prediction(top_symbol, tokens[pos]);
+        std::span<const symbol_id> d_symbols;
+        if (production != Grammar::kNoProduction) {
+            d_symbols = parser_.PushSequence(production);
+        } else if (gr_.HasEmptyProduction(top_symbol)) {
+            production = gr_.EmptyProduction(top_symbol);
+        } else {
+            status = REJECTED;
+            break;
+        }
+        visitor.EnterNonTerminal(top_symbol, production, d_symbols.size(),
+                                 ranges[pos].begin);
+        open_begins_.push_back(ranges[pos].begin);
+        symbol_stack_.push_back(top_symbol | kCloseBit);
+        symbol_stack_.insert(symbol_stack_.end(), d_symbols.begin(),
+                             d_symbols.end());
+    }
+    trace_.Record(tokens.first(pos));
+    return status;
+}
+
+template <parse_visitor Visitor>
+void ParseSession::FinishEvents(Visitor& visitor) {
+    for (symbol_id symbol : std::ranges::reverse_view(symbol_stack_)) {
+        if ((symbol & kCloseBit) != 0) {
+            visitor.ExitNonTerminal(symbol & ~kCloseBit, CloseOffset());
+        }
+    }
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include "arena.hpp"
+#include "grammar.hpp"
+#include "lexer.hpp"
+#include "ll1_parser.hpp"
+#include "symbol_table.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Node of a concrete syntax tree.
+ *
+ * Terminal nodes are leaves holding the byte range of their token. Non-terminal
+ * nodes hold the production they were expanded with and one child per symbol
+ * of its right-hand side (EPSILON excluded), in order; their byte range spans
+ * the tokens they derive, and is empty, at the position where they were
+ * expanded, if they derive none.
+ */
+struct parse_node {
+    /// @brief Grammar symbol of the node.
+    symbol_id symbol{symbol_table::kEpsilon};
+
+    /// @brief Production applied, `Grammar::kNoProduction` for terminals.
+    std::uint32_t production{Grammar::kNoProduction};
+
+    /// @brief Number of children.
+    std::uint32_t num_children{0};
+
+    /// @brief Children, stored contiguously in the tree arena.
+    parse_node* children{nullptr};
+
+    /// @brief Offset in the input of the first byte derived by the node.
+    std::size_t begin{0};
+
+    /// @brief Offset in the input past the last byte derived by the node.
+    std::size_t end{0};
+
+    /// @brief Children of the node, in order.
+    std::span<const parse_node> Children() const {
+        return {children, num_children};
+    }
+};
+
+/**
+ * @brief Concrete syntax tree built by `TreeBuilder`.
+ *
+ * Every node lives in the tree's arena, so building the tree makes no
+ * per-node heap allocation and clearing it frees all nodes in one shot. A tree
+ * can be reused for several parses; its memory is recycled.
+ */
+class ParseTree {
+  public:
+    /// @brief Root of the tree, null if no input was accepted.
+    const parse_node* Root() const { return root_; }
+
+    /// @brief Frees every node.
+    void Clear() {
+        arena_.Clear();
+        root_ = nullptr;
+    }
+
+    /**
+     * @brief Allocates the root node. Previous nodes are kept until `Clear`.
+     *
+     * @return The new root, value-initialized.
+     */
+    parse_node* NewRoot() {
+        root_ = arena_.Allocate<parse_node>(1);
+        return root_;
+    }
+
+    /**
+     * @brief Allocates the contiguous children of a node.
+     *
+     * @param n Number of children.
+     * @return The first child, value-initialized; null if `n` is 0.
+     */
+    parse_node* NewChildren(std::size_t n) {
+        return arena_.Allocate<parse_node>(n);
+    }
+
+    /// @brief Marks the tree as not holding an accepted input.
+    void Discard() { root_ = nullptr; }
+
+    /**
+     * @brief Prints the tree, one node per line, indented by depth.
+     *
+     * Each line has the symbol name and the byte range `[begin, end)` of the
+     * node.
+     *
+     * @param st Symbol table of the grammar used to build the tree.
+     * @param out Stream to print to.
+     */
+    void Print(const symbol_table& st, std::ostream& out) const;
+
+  private:
+    /// @brief Memory of every node.
+    Arena arena_;
+
+    /// @brief Root node, null if empty.
+    parse_node* root_{nullptr};
+};
+
+/**
+ * @brief Parse visitor that builds the concrete syntax tree of the input, see
+ * `parse_visitor`.
+ *
+ * Each node is filled in when its event arrives: the children of a
+ * non-terminal are allocated when it is entered and then filled in order. If
+ * the input ends before the stack empties, the children never reached become
+ * empty nodes at the end of their parent.
+ */
+class TreeBuilder {
+  public:
+    /**
+     * @brief Constructs a builder, clearing `tree`.
+     *
+     * @param parser Parser whose events are received.
+     * @param tree Tree to build; it must outlive the builder.
+     */
+    TreeBuilder(const LL1Parser& parser, ParseTree& tree);
+
+    void EnterNonTerminal(symbol_id non_terminal, std::uint32_t production,
+                          std::size_t num_children, std::size_t begin) {
+        parse_node* node   = NextNode();
+        node->symbol       = non_terminal;
+        node->production   = production;
+        node->num_children = static_cast<std::uint32_t>(num_children);
+        node->children     = tree_.NewChildren(num_children);
+        node->begin        = begin;
+        open_.push_back({node, 0});
+    }
+
+    void ExitNonTerminal(symbol_id non_terminal, std::size_t end);
+
+    void ShiftTerminal(symbol_id terminal, token_range range) {
+        parse_node* node = NextNode();
+        node->symbol     = terminal;
+        node->begin      = range.begin;
+        node->end        = range.end;
+    }
+
+  private:
+    /// @brief Non-terminal node whose children are being filled.
+    struct open_node {
+        parse_node*   node;
+        /// @brief Number of children filled so far.
+        std::uint32_t filled;
+    };
+
+    /// @brief Next node to fill: the root, or the next child of the
+    /// innermost open node.
+    parse_node* NextNode() {
+        if (open_.empty()) {
+            return tree_.NewRoot();
+        }
+        open_node& parent = open_.back();
+        return parent.node->children + parent.filled++;
+    }
+
+    /// @brief Parser whose push sequences name the children never reached.
+    const LL1Parser& parser_;
+
+    /// @brief Tree being built.
+    ParseTree& tree_;
+
+    /// @brief Open non-terminals, the innermost last.
+    std::vector<open_node> open_;
+};
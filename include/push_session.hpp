@@ -0,0 +1,233 @@
+#pragma once
+#include "grammar.hpp"
+#include "lexer.hpp"
+#include "ll1_parser.hpp"
+#include "parse_events.hpp"
+#include "symbol_table.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Parse of an input that arrives in pieces, e.g. network chunks,
+ * pushed by the caller.
+ *
+ * The parse is a coroutine that lexes and parses as far as the bytes pushed
+ * so far allow, handing out the events of the derivation one at a time (see
+ * `parse_event`), and suspends when it runs out of complete tokens. Its stack
+ * and the bytes of a token cut by a chunk boundary stay in the coroutine
+ * until the next `Push`, so validation overlaps with I/O and memory depends
+ * on the chunk size and the stack depth, not on the input size:
+ *
+ * ~~~{.cpp}
+ * PushSession session{parser};
+ * while (receive(chunk)) {
+ *     for (const parse_event& event : session.Push(chunk)) { ... }
+ * }
+ * for (const parse_event& event : session.Finish()) { ... }
+ * bool accepted = session.Accepted();
+ * ~~~
+ *
+ * The events and the result are those `ParseSession::ParseText` gives for
+ * the whole input. A token is lexed once another lexeme follows it, or at
+ * `Finish`: only the bytes of the last token are kept between pushes and
+ * scanned again, see `Lex::Feed`. A session parses a single input and cannot
+ * be moved.
+ */
+class PushSession {
+    /// @brief Coroutine of the parse, suspended at every event.
+    class parse_task {
+      public:
+        /// @brief Tag yielded when the pushed bytes are used up.
+        struct need_input {};
+
+        struct promise_type {
+            /// @brief Last event yielded, null while waiting for input.
+            const parse_event* event{nullptr};
+            /// @brief Exception that ended the parse, rethrown to the caller.
+            std::exception_ptr error;
+
+            parse_task get_return_object() {
+                return parse_task{
+                    std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            std::suspend_always yield_value(const parse_event& e) noexcept {
+                event = &e;
+                return {};
+            }
+            std::suspend_always yield_value(need_input) noexcept {
+                event = nullptr;
+                return {};
+            }
+            void return_void() noexcept { event = nullptr; }
+            void unhandled_exception() noexcept {
+                event = nullptr;
+                error = std::current_exception();
+            }
+        };
+
+        explicit parse_task(std::coroutine_handle<promise_type> handle)
+            : handle_(handle) {}
+        parse_task(parse_task&& other) noexcept
+            : handle_(std::exchange(other.handle_, {})) {}
+        parse_task& operator=(parse_task&&) = delete;
+        ~parse_task() {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+        /**
+         * @brief Runs the parse to its next event.
+         *
+         * @return The event, or null if the parse waits for input or is over.
+         *
+         * @throws LexerError If the input contains an invalid token.
+         */
+        const parse_event* Next();
+
+        /// @brief Whether the parse is over.
+        bool Done() const { return handle_.done(); }
+
+      private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+  public:
+    /**
+     * @brief Events of the input pushed so far, produced while iterating.
+     *
+     * Each step of the iteration resumes the parse until its next event;
+     * the iteration ends when the parse needs more input or is over.
+     */
+    class event_range {
+      public:
+        class iterator {
+          public:
+            using value_type      = parse_event;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+            explicit iterator(parse_task* task)
+                : task_(task), event_(task->Next()) {}
+
+            const parse_event& operator*() const { return *event_; }
+            const parse_event* operator->() const { return event_; }
+            iterator&          operator++() {
+                event_ = task_->Next();
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+            bool operator==(std::default_sentinel_t) const {
+                return event_ == nullptr;
+            }
+
+          private:
+            parse_task*        task_{nullptr};
+            const parse_event* event_{nullptr};
+        };
+
+        explicit event_range(parse_task* task) : task_(task) {}
+
+        /// @brief Resumes the parse up to its first event.
+        iterator begin() { return iterator(task_); }
+
+        std::default_sentinel_t end() const { return {}; }
+
+      private:
+        parse_task* task_;
+    };
+
+    /**
+     * @brief Constructs a session for a parser, the parse suspended before
+     * its first token.
+     *
+     * @param parser Compiled grammar to parse with; it must outlive the
+     * session.
+     */
+    explicit PushSession(const LL1Parser& parser);
+
+    PushSession(const PushSession&)            = delete;
+    PushSession& operator=(const PushSession&) = delete;
+
+    /**
+     * @brief Appends the next bytes of the input.
+     *
+     * Nothing is lexed or parsed until the returned range is iterated; bytes
+     * pushed after the parse is over are dropped.
+     *
+     * @param bytes Next bytes of the input, copied.
+     * @return The events the parse can produce with the input pushed so far.
+     *
+     * @throws LexerError While iterating, if the input contains an invalid
+     * token.
+     */
+    event_range Push(std::string_view bytes);
+
+    /**
+     * @brief Marks the end of the input.
+     *
+     * @return The remaining events, up to the end of the parse.
+     *
+     * @throws LexerError While iterating, if the input contains an invalid
+     * token.
+     */
+    event_range Finish();
+
+    /// @brief Whether the parse is over: rejected, accepted or finished.
+    bool Done() const { return task_.Done(); }
+
+    /// @brief Whether the input pushed so far is accepted; the result of the
+    /// parse once `Done`.
+    bool Accepted() const { return !rejected_; }
+
+  private:
+    /// @brief Marks a stack entry as the end of the symbols derived by a
+    /// non-terminal, see `ParseSession`.
+    static constexpr symbol_id kCloseBit{symbol_id{1} << 31};
+
+    /// @brief Body of the parse coroutine.
+    parse_task Run();
+
+    /**
+     * @brief Lexes the pushed bytes up to their last token, or all of them
+     * after `Finish`, and drops them.
+     *
+     * @param tokens Receives the token IDs.
+     * @param ranges Receives the byte range of each token in the input.
+     */
+    void LexInput(std::vector<symbol_id>&   tokens,
+                  std::vector<token_range>& ranges);
+
+    /// @brief Compiled grammar shared with other sessions.
+    const LL1Parser& parser_;
+
+    /// @brief Grammar of `parser_`.
+    const Grammar& gr_;
+
+    /// @brief Bytes pushed and not lexed yet.
+    std::string input_;
+
+    /// @brief Number of bytes of `input_` held back by the lexer, already
+    /// scanned once.
+    std::size_t held_{0};
+
+    /// @brief Whether `Finish` was called.
+    bool finished_{false};
+
+    /// @brief Whether the input is rejected.
+    bool rejected_{false};
+
+    /// @brief Lexer for the grammar terminals.
+    Lex lex_;
+
+    /// @brief The parse, last so that it is destroyed first.
+    parse_task task_;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include "symbol_table.hpp"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Fixed-capacity ring with the last symbols processed by the parser.
+ *
+ * Only symbol IDs are stored; names are looked up when the history is
+ * printed. A capacity of zero disables the history, making every call a
+ * no-op.
+ */
+class SymbolHistory {
+  public:
+    /**
+     * @brief Constructs an empty history.
+     *
+     * @param capacity Number of symbols kept, 0 disables the history.
+     */
+    explicit SymbolHistory(std::size_t capacity) : ring_(capacity) {}
+
+    /**
+     * @brief Appends symbols to the history, oldest first.
+     *
+     * Only the last `Capacity()` symbols can survive, so at most that many
+     * are copied whatever the length of `symbols`.
+     *
+     * @param symbols Symbols processed, in order.
+     */
+    void Record(std::span<const symbol_id> symbols);
+
+    /// @brief Forgets every recorded symbol.
+    void Clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    /// @brief Maximum number of symbols kept.
+    std::size_t Capacity() const { return ring_.size(); }
+
+    /// @brief Number of symbols currently kept.
+    std::size_t Size() const { return size_; }
+
+    /**
+     * @brief Calls `f` with every recorded symbol, from the oldest to the
+     * most recent.
+     */
+    template <typename F> void ForEach(F&& f) const {
+        std::size_t start{head_ + ring_.size() - size_};
+        for (std::size_t i = 0; i < size_; ++i) {
+            f(ring_[(start + i) % ring_.size()]);
+        }
+    }
+
+  private:
+    /// @brief Storage of the ring, `Capacity()` elements.
+    std::vector<symbol_id> ring_;
+
+    /// @brief Position where the next symbol is written.
+    std::size_t head_{0};
+
+    /// @brief Number of valid symbols in the ring.
+    std::size_t size_{0};
+};
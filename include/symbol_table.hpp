@@ -1,57 +1,74 @@
 #pragma once
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <unordered_map>
-#include <utility>
 #include <vector>
 
+/// @brief Dense integer identifier of a grammar symbol. Terminals take the
+/// lowest IDs, non-terminals follow them.
+using symbol_id = std::uint32_t;
+
 enum symbol_type { NO_TERMINAL, TERMINAL };
 
+/**
+ * @brief Symbols of one grammar.
+ *
+ * Each Grammar owns its own table, so several grammars can be loaded and used
+ * concurrently in the same process. Once the grammar is read the table is
+ * only queried, which is safe from several threads.
+ */
 struct symbol_table {
+    /// @brief Epsilon symbol, representing empty transitions, initialized as
+    /// "EPSILON". It is the same for every grammar.
+    inline static const std::string EPSILON_{"EPSILON"};
+
     /// @brief End-of-line symbol used in parsing, initialized as "$".
-    inline static std::string EOL_{"$"};
+    std::string EOL_{"$"};
 
-    /// @brief Epsilon symbol, representing empty transitions, initialized as
-    /// "EPSILON".
-    inline static std::string EPSILON_{"EPSILON"};
+    /// @brief ID of the epsilon symbol.
+    static constexpr symbol_id kEpsilon{0};
 
-    /// @brief Main symbol table, mapping identifiers to a pair of symbol type
-    /// and its regex.
-    inline static std::unordered_map<std::string,
-                                     std::pair<symbol_type, std::string>>
-        st_{{EOL_, {TERMINAL, EOL_}}, {EPSILON_, {TERMINAL, EPSILON_}}};
+    /// @brief ID of the end-of-line symbol. It is also its lexer token ID.
+    static constexpr symbol_id kEol{1};
 
-    /// @brief Token types, mapping each symbol to a unique integer ID.
-    inline static std::unordered_map<std::string, unsigned long> token_types_{
-        {EOL_, 1}};
+    /// @brief Sentinel ID meaning "no symbol", e.g. end of the token stream.
+    static constexpr symbol_id kNone{std::numeric_limits<symbol_id>::max()};
 
-    /// @brief Reverse mapping from integer token IDs back to symbols.
-    inline static std::unordered_map<unsigned long, std::string> token_types_r_{
-        {1, EOL_}};
+    /// @brief Maps each symbol name to its ID. Only used while the grammar is
+    /// being read; everything afterwards works with IDs.
+    std::unordered_map<std::string, symbol_id> ids_{
+        {EPSILON_, kEpsilon}, {EOL_, kEol}};
 
-    /// @brief Tracks insertion order of token types.
-    inline static std::vector<unsigned long> order_{1};
+    /// @brief Symbol names indexed by ID, kept for printing.
+    std::vector<std::string> names_{EPSILON_, EOL_};
 
-    /// @brief Current index for assigning new token IDs, starting from 2.
-    inline static unsigned long i_{2};
+    /// @brief Regex of each terminal, indexed by ID.
+    std::vector<std::string> regex_{EPSILON_, EOL_};
 
     /**
      * @brief Adds a terminal symbol with its associated regex to the symbol
      * table.
      *
-     * Updates the token type mappings and tracks insertion order.
+     * Terminals must be added before any non-terminal, so that their IDs are
+     * contiguous and can be used directly as lexer token IDs. Redefining a
+     * terminal only updates its regex.
      *
      * @param identifier Name of the terminal symbol.
      * @param regex Regular expression representing the terminal symbol.
+     * @return ID assigned to the terminal.
      */
-    static void PutSymbol(const std::string& identifier,
-                          const std::string& regex);
+    symbol_id PutSymbol(const std::string& identifier,
+                        const std::string& regex);
 
     /**
      * @brief Adds a non-terminal symbol to the symbol table.
      *
      * @param identifier Name of the non-terminal symbol.
+     * @return ID assigned to the non-terminal, or the existing ID if the
+     * symbol was already present.
      */
-    static void PutSymbol(const std::string& identifier);
+    symbol_id PutSymbol(const std::string& identifier);
 
     /**
      * @brief Checks if a symbol exists in the symbol table.
@@ -59,35 +76,76 @@ struct symbol_table {
      * @param s Symbol identifier to search.
      * @return true if the symbol is present, otherwise false.
      */
-    static bool In(const std::string& s);
+    bool In(const std::string& s) const;
+
+    /**
+     * @brief Retrieves the ID of a symbol.
+     *
+     * @param s Symbol identifier.
+     * @return ID of the symbol.
+     * @throws std::out_of_range if the symbol is not in the table.
+     */
+    symbol_id Id(const std::string& s) const;
 
     /**
      * @brief Checks if a symbol is a terminal.
      *
-     * @param s Symbol identifier to check.
+     * @param id Symbol ID to check.
      * @return true if the symbol is terminal, otherwise false.
      */
-    static bool IsTerminal(const std::string& s);
+    bool IsTerminal(symbol_id id) const { return id < regex_.size(); }
+
+    /**
+     * @brief Retrieves the name of a symbol.
+     *
+     * @param id Symbol ID.
+     * @return Name of the symbol.
+     */
+    const std::string& Name(symbol_id id) const { return names_[id]; }
 
     /**
      * @brief Retrieves the regex pattern for a terminal symbol.
      *
-     * @param terminal Terminal symbol identifier.
+     * @param terminal Terminal symbol ID.
      * @return Regex pattern associated with the terminal symbol.
      */
-    static std::string GetValue(const std::string& terminal);
+    const std::string& GetValue(symbol_id terminal) const;
+
+    /**
+     * @brief Number of terminal symbols, including EPSILON and EOL. It is also
+     * the ID of the first non-terminal.
+     */
+    symbol_id NumTerminals() const {
+        return static_cast<symbol_id>(regex_.size());
+    }
+
+    /**
+     * @brief Position of a non-terminal among the non-terminals, used to
+     * index per non-terminal arrays.
+     *
+     * @param id Non-terminal symbol ID.
+     */
+    symbol_id NonTerminalIndex(symbol_id id) const {
+        return id - NumTerminals();
+    }
+
+    /// @brief Number of non-terminal symbols.
+    symbol_id NumNonTerminals() const { return Size() - NumTerminals(); }
+
+    /// @brief Total number of symbols in the table.
+    symbol_id Size() const { return static_cast<symbol_id>(names_.size()); }
 
     /**
      * @brief Prints all symbols and their properties in the symbol table.
      *
      * Outputs the symbol table for debugging purposes.
      */
-    static void Debug();
+    void Debug() const;
 
     /**
      * @brief Sets the end-of-line symbol.
      *
      * @param eol String to use as the new end-of-line symbol.
      */
-    static void SetEol(const std::string& eol);
+    void SetEol(const std::string& eol);
 };
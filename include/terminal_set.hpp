@@ -0,0 +1,109 @@
+#pragma once
+#include "symbol_table.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Fixed-width set of terminals, stored as a bitset over terminal IDs.
+ *
+ * The width is the number of terminals of the grammar, so bit
+ * `symbol_table::kEpsilon` doubles as the epsilon flag used by FIRST sets.
+ * Unions and intersections work one 64-bit word at a time.
+ */
+class TerminalSet {
+  public:
+    TerminalSet() = default;
+
+    /**
+     * @brief Constructs an empty set able to hold `size` terminals.
+     *
+     * @param size Number of terminals of the grammar.
+     */
+    explicit TerminalSet(std::size_t size)
+        : words_((size + kWordBits - 1) / kWordBits) {}
+
+    /**
+     * @brief Checks if a terminal is in the set.
+     *
+     * @param t Terminal symbol ID.
+     * @return true if `t` is in the set, otherwise false.
+     */
+    bool Contains(symbol_id t) const {
+        return (words_[t / kWordBits] >> (t % kWordBits)) & 1U;
+    }
+
+    /**
+     * @brief Adds a terminal to the set.
+     *
+     * @param t Terminal symbol ID.
+     * @return true if `t` was not already in the set.
+     */
+    bool Insert(symbol_id t) {
+        std::uint64_t  bit  = std::uint64_t{1} << (t % kWordBits);
+        std::uint64_t& word = words_[t / kWordBits];
+        bool           added{(word & bit) == 0};
+        word |= bit;
+        return added;
+    }
+
+    /**
+     * @brief Removes a terminal from the set.
+     *
+     * @param t Terminal symbol ID.
+     */
+    void Erase(symbol_id t) {
+        words_[t / kWordBits] &= ~(std::uint64_t{1} << (t % kWordBits));
+    }
+
+    /**
+     * @brief Adds every terminal of another set of the same width.
+     *
+     * @param other Set to merge into this one.
+     * @return true if this set changed.
+     */
+    bool Merge(const TerminalSet& other);
+
+    /**
+     * @brief Adds every terminal of another set except epsilon.
+     *
+     * @param other Set to merge into this one.
+     * @return true if this set changed.
+     */
+    bool MergeWithoutEpsilon(const TerminalSet& other);
+
+    /**
+     * @brief Checks if two sets of the same width share any terminal.
+     *
+     * @param other Set to intersect with.
+     * @return true if the intersection is not empty.
+     */
+    bool Intersects(const TerminalSet& other) const;
+
+    /// @brief Checks if the set holds no terminal.
+    bool Empty() const;
+
+    /**
+     * @brief Calls `f` with the ID of every terminal in the set, in
+     * increasing order.
+     */
+    template <typename F> void ForEach(F&& f) const {
+        for (std::size_t w = 0; w < words_.size(); ++w) {
+            std::uint64_t word = words_[w];
+            while (word != 0) {
+                f(static_cast<symbol_id>(w * kWordBits +
+                                         std::countr_zero(word)));
+                word &= word - 1;
+            }
+        }
+    }
+
+    bool operator==(const TerminalSet& other) const = default;
+
+  private:
+    static constexpr std::size_t kWordBits{64};
+
+    /// @brief Bit words, terminal `t` is bit `t % 64` of word `t / 64`.
+    std::vector<std::uint64_t> words_;
+};
@@ -0,0 +1,163 @@
+#pragma once
+#include "lexer.hpp"
+#include "ll1_parser.hpp"
+#include "symbol_table.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief Whether `ThreadedSession` dispatches through computed gotos
+/// (GCC/Clang "labels as values"). Define it to 0 to use the portable switch.
+#ifndef LL1_COMPUTED_GOTO
+#if defined(__GNUC__)
+#define LL1_COMPUTED_GOTO 1
+#else
+#define LL1_COMPUTED_GOTO 0
+#endif
+#endif
+
+/**
+ * @brief Parse session running a direct-threaded interpreter of the LL(1)
+ * table.
+ *
+ * Same results as `ParseSession`, with a different engine. Instead of symbol
+ * IDs, the stack holds instructions classified when the session is built:
+ *
+ * - `MATCH t`: compare the next token with terminal `t` and consume it.
+ * - `PREDICT r`: expand a non-terminal, `r` being the start of its row in
+ *   the table, so the cell is one load away.
+ * - `ACCEPT`: bottom of the stack, the input is accepted.
+ * - `REJECT`: pushed by the empty cells, the input is rejected.
+ *
+ * Each cell holds the instructions its production pushes; the cells of a
+ * non-terminal with an empty production that the table leaves empty push
+ * nothing, the others push `REJECT`. The loop thus never tests for a
+ * terminal, an empty cell or an empty stack: every step jumps straight to
+ * the handler of the instruction on top, through a table of label addresses
+ * when `LL1_COMPUTED_GOTO` is set, so each handler ends with its own
+ * indirect branch, which the CPU predicts per handler.
+ *
+ * The instructions are compiled from an `LL1Parser` at construction, once
+ * per session, which can then be reused for many inputs. No symbol history
+ * is kept.
+ */
+class ThreadedSession {
+  public:
+    /// @brief Whether the interpreter dispatches through computed gotos.
+    static constexpr bool kComputedGoto{LL1_COMPUTED_GOTO != 0};
+
+    /**
+     * @brief Compiles the instructions of a parser.
+     *
+     * @param parser Compiled grammar to parse with; it must outlive the
+     * session.
+     *
+     * @throws std::length_error If the table is too large for the operands
+     * of the instructions.
+     */
+    explicit ThreadedSession(const LL1Parser& parser);
+
+    /**
+     * @brief Parses an input file, see `ParseSession::ParseFile`.
+     *
+     * @param filename Path to the input file.
+     * @return `true` if the input is accepted, `false` otherwise.
+     *
+     * @throws LexerError If the file cannot be opened or contains an invalid
+     * token.
+     */
+    bool ParseFile(const std::string& filename);
+
+    /**
+     * @brief Parses an input held in memory, see `ParseSession::ParseText`.
+     *
+     * @param text Input text.
+     * @return `true` if the input is accepted, `false` otherwise.
+     *
+     * @throws LexerError If the text contains an invalid token.
+     */
+    bool ParseText(std::string_view text);
+
+    /**
+     * @brief Parses a sequence of already lexed tokens, see
+     * `ParseSession::Parse`.
+     *
+     * @param tokens Token IDs of the input, in order.
+     * @return `true` if the tokens are accepted, `false` otherwise.
+     */
+    bool Parse(std::span<const symbol_id> tokens);
+
+  private:
+    /// @brief State of a parse after feeding it some tokens.
+    enum parse_status { RUNNING, ACCEPTED, REJECTED };
+
+    /// @brief Kind of an instruction, in its top bits.
+    enum opcode : std::uint32_t { MATCH, PREDICT, ACCEPT, REJECT };
+
+    /// @brief Instruction: opcode and operand packed in one word.
+    using instruction = std::uint32_t;
+
+    /// @brief Number of bits of the operand of an instruction.
+    static constexpr unsigned kOperandBits{30};
+
+    /// @brief Mask of the operand of an instruction.
+    static constexpr instruction kOperandMask{(instruction{1} << kOperandBits) -
+                                              1};
+
+    /// @brief Initial capacity of the stack.
+    static constexpr std::size_t kInitialStackSize{1024};
+
+    /// @brief Instructions pushed by a cell: `[begin, end)` of `code_`.
+    struct cell {
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    /// @brief Packs an opcode and its operand.
+    static constexpr instruction Encode(opcode op, std::uint32_t operand) {
+        return (instruction{op} << kOperandBits) | operand;
+    }
+
+    /// @brief Instruction that stands for a symbol on the stack.
+    instruction Compile(symbol_id symbol) const;
+
+    /// @brief Runs the lexer to the end, feeding each chunk to the parse.
+    bool ParseLexed();
+
+    /// @brief Resets the stack to the axiom above `ACCEPT`.
+    void StartParse();
+
+    /**
+     * @brief Runs the interpreter over the next tokens of the input.
+     *
+     * @param tokens Next token IDs of the input, in order.
+     * @return `RUNNING` if every token was consumed, `ACCEPTED` or
+     * `REJECTED` if the parse stopped.
+     */
+    parse_status Feed(std::span<const symbol_id> tokens);
+
+    /// @brief Compiled grammar shared with other sessions.
+    const LL1Parser& parser_;
+
+    /// @brief Instructions pushed by every production, in push order, then
+    /// a lone `REJECT`.
+    std::vector<instruction> code_;
+
+    /// @brief LL(1) table of instructions, row-major.
+    std::vector<cell> cells_;
+
+    /// @brief Largest number of instructions a cell pushes.
+    std::size_t max_push_{1};
+
+    /// @brief Parse stack, its top is `stack_[depth_ - 1]`.
+    std::vector<instruction> stack_;
+
+    /// @brief Number of instructions on the stack.
+    std::size_t depth_{0};
+
+    /// @brief Lexer for the grammar terminals, reused for every input.
+    Lex lex_;
+};
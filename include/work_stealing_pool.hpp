@@ -0,0 +1,112 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Runs a batch of independent tasks on a fixed number of threads.
+ *
+ * Tasks are numbered `0` to `n - 1` and split in contiguous blocks, one per
+ * worker. Each worker runs its own block from the front and, once it is
+ * empty, steals from the back of the other blocks, so uneven tasks still keep
+ * every thread busy.
+ *
+ * The worker threads are started once by the constructor and wait between
+ * batches, so running many small batches does not pay thread start-up each
+ * time.
+ */
+class WorkStealingPool {
+  public:
+    /// @brief Task to run: receives the worker index and the task index.
+    using task = std::function<void(unsigned worker, std::size_t index)>;
+
+    /**
+     * @brief Constructs a pool.
+     *
+     * @param num_threads Number of worker threads, 0 means one per hardware
+     * thread.
+     */
+    explicit WorkStealingPool(unsigned num_threads);
+
+    WorkStealingPool(const WorkStealingPool&)            = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /// @brief Stops and joins the worker threads.
+    ~WorkStealingPool();
+
+    /// @brief Number of worker threads, also the bound of worker indices.
+    unsigned NumThreads() const { return num_threads_; }
+
+    /**
+     * @brief Runs `f` for every task index and waits for all of them.
+     *
+     * A task index is only passed to one worker, and a worker runs its tasks
+     * one at a time, so per-worker state needs no locking. Worker 0 is the
+     * calling thread. Batches from several threads run one after the other;
+     * `f` must not call `Run` on the same pool.
+     *
+     * @param num_tasks Number of tasks.
+     * @param f Function run for each task; it must not throw.
+     */
+    void Run(std::size_t num_tasks, const task& f);
+
+  private:
+    /// @brief Tasks not yet started by a worker.
+    struct work_queue {
+        std::mutex              mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    /**
+     * @brief Takes the next task of a worker, stealing one if its own queue
+     * is empty.
+     *
+     * @param worker Worker index.
+     * @param index Set to the task index.
+     * @return false if every queue is empty.
+     */
+    bool NextTask(unsigned worker, std::size_t& index);
+
+    /// @brief Runs the tasks of the current batch until every queue is empty.
+    void Work(unsigned worker, const task& f);
+
+    /// @brief Body of worker thread `worker`: runs each batch as it starts.
+    void WorkerLoop(unsigned worker);
+
+    /// @brief Number of worker threads.
+    unsigned num_threads_;
+
+    /// @brief One queue per worker.
+    std::deque<work_queue> queues_;
+
+    /// @brief Serializes the batches of `Run`.
+    std::mutex run_mutex_;
+
+    /// @brief Guards the batch state below.
+    std::mutex state_mutex_;
+
+    /// @brief Signals the workers that a batch started or the pool stops.
+    std::condition_variable start_;
+
+    /// @brief Signals `Run` that every worker finished the batch.
+    std::condition_variable finished_;
+
+    /// @brief Function of the current batch.
+    const task* task_{nullptr};
+
+    /// @brief Number of batches started, so workers tell a new one apart.
+    std::size_t generation_{0};
+
+    /// @brief Worker threads still running the current batch.
+    unsigned busy_{0};
+
+    /// @brief Set by the destructor to stop the workers.
+    bool stop_{false};
+
+    /// @brief Worker threads 1 to `num_threads_ - 1`.
+    std::vector<std::thread> threads_;
+};
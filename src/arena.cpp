@@ -0,0 +1,22 @@
+#include "../include/arena.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+void* Arena::AllocateBytes(std::size_t size, std::size_t align) {
+    while (current_ < blocks_.size()) {
+        block&      b = blocks_[current_];
+        std::size_t start{(used_ + align - 1) / align * align};
+        if (start + size <= b.size) {
+            used_ = start + size;
+            return b.data.get() + start;
+        }
+        ++current_;
+        used_ = 0;
+    }
+    std::size_t block_size{std::max(block_size_, size)};
+    blocks_.push_back(
+        {std::unique_ptr<std::byte[]>(new std::byte[block_size]), block_size});
+    used_ = size;
+    return blocks_.back().data.get();
+}
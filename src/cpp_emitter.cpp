@@ -0,0 +1,366 @@
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include "../include/cpp_emitter.hpp"
+#include "../include/grammar.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/symbol_table.hpp"
+
+namespace {
+
+/// @brief C++ keywords, which cannot name the generated namespace or struct.
+const std::unordered_set<std::string_view> kKeywords{
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor",
+    "bool", "break", "case", "catch", "char", "char8_t", "char16_t",
+    "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr",
+    "constinit", "const_cast", "continue", "co_await", "co_return", "co_yield",
+    "decltype", "default", "delete", "do", "double", "dynamic_cast", "else",
+    "enum", "explicit", "export", "extern", "false", "float", "for", "friend",
+    "goto", "if", "inline", "int", "long", "mutable", "namespace", "new",
+    "noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq",
+    "private", "protected", "public", "register", "reinterpret_cast",
+    "requires", "return", "short", "signed", "sizeof", "static",
+    "static_assert", "static_cast", "struct", "switch", "template", "this",
+    "thread_local", "throw", "true", "try", "typedef", "typeid", "typename",
+    "union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t",
+    "while", "xor", "xor_eq",
+};
+
+/// @brief Parser of the generated source, written after the tables.
+constexpr std::string_view kRuntime{R"(
+/// State of a parse after feeding it some tokens.
+enum parse_status {
+    RUNNING,  ///< Every token was consumed, more may follow.
+    ACCEPTED, ///< The stack emptied, the input is accepted.
+    REJECTED  ///< A token did not match, the input is rejected.
+};
+
+/// Table-driven LL(1) parser. The input can be fed in several pieces.
+class Parser {
+  public:
+    Parser() { Reset(); }
+
+    /// Starts a new parse.
+    void Reset() {
+        stack_.reserve(1024);
+        stack_.clear();
+        stack_.push_back(kAxiom);
+        status_ = RUNNING;
+    }
+
+    /// Parses the next tokens of the input, the IDs of `terminal`.
+    parse_status Feed(const std::uint32_t* tokens, std::size_t n) {
+        for (std::size_t pos = 0; status_ == RUNNING && pos < n;) {
+            if (stack_.empty()) {
+                status_ = ACCEPTED;
+                break;
+            }
+            std::uint32_t top = stack_.back();
+            stack_.pop_back();
+            if (top < kNumTerminals) {
+                if (top != tokens[pos++]) {
+                    status_ = REJECTED;
+                }
+                continue;
+            }
+            std::size_t   row = top - kNumTerminals;
+            production_id p   = kTable[row * kNumTerminals + tokens[pos]];
+            if (p != kNoProduction) {
+                stack_.insert(stack_.end(), kPushSymbols + kPushOffsets[p],
+                              kPushSymbols + kPushOffsets[p + 1]);
+            } else if (!kHasEmptyProduction[row]) {
+                status_ = REJECTED;
+            }
+        }
+        return status_;
+    }
+
+    /// Whether the input fed so far conforms to the grammar.
+    bool Accepted() const { return status_ != REJECTED; }
+
+  private:
+    std::vector<std::uint32_t> stack_;
+    parse_status               status_{RUNNING};
+};
+
+/// Parses a whole input given as token IDs.
+inline bool Parse(const std::uint32_t* tokens, std::size_t n) {
+    Parser parser;
+    parser.Feed(tokens, n);
+    return parser.Accepted();
+}
+)"};
+
+/// @brief Number of values written per line in the arrays.
+constexpr std::size_t kValuesPerLine{10};
+
+/// @brief Value of `kNoProduction` in the generated code: 16-bit cells halve
+/// the table when the productions fit.
+std::uint32_t NoProduction(std::uint32_t num_productions) {
+    return num_productions < std::numeric_limits<std::uint16_t>::max()
+               ? std::numeric_limits<std::uint16_t>::max()
+               : std::numeric_limits<std::uint32_t>::max();
+}
+
+} // namespace
+
+CppEmitter::CppEmitter(const LL1Parser& parser, std::string_view name)
+    : parser_(parser), st_(parser.GetGrammar().st_),
+      name_(Identifier(name)) {
+    if (name_.empty() || std::isdigit(static_cast<unsigned char>(name_[0]))) {
+        name_.insert(0, "ll1_");
+    } else if (kKeywords.contains(name_)) {
+        name_ += '_';
+    }
+}
+
+void CppEmitter::Emit(std::ostream& out) const {
+    const layout source{"", "inline constexpr"};
+    out << "// LL(1) parser generated by ll1 --emit-cpp. Do not edit.\n"
+        << "//\n"
+        << "// Parse() tells whether a sequence of token IDs conforms to the\n"
+        << "// grammar. The table is static data, nothing is computed at\n"
+        << "// startup. Every definition is inline, so the file can be\n"
+        << "// compiled on its own or included.\n\n"
+        << "#include <cstddef>\n#include <cstdint>\n#include <vector>\n\n"
+        << "namespace " << name_ << " {\n\n";
+
+    EmitTerminals(out, source);
+    EmitSymbols(out, source);
+    EmitTable(out, source);
+    EmitProductions(out);
+    out << kRuntime << "\n} // namespace " << name_ << "\n";
+}
+
+void CppEmitter::EmitHeader(std::ostream& out) const {
+    const layout member{"    ", "static constexpr"};
+    out << "// LL(1) tables generated by ll1 --emit-header. Do not edit.\n"
+        << "//\n"
+        << "// Every member is a static constexpr array, to parse with\n"
+        << "// TableParser<" << name_ << "> from ll1_runtime.hpp or with any\n"
+        << "// other code that reads the tables at compile time.\n\n"
+        << "#pragma once\n#include <cstdint>\n\n"
+        << "struct " << name_ << " {\n";
+
+    EmitTerminals(out, member);
+    EmitSymbols(out, member);
+    EmitRules(out, member);
+    EmitTable(out, member);
+    EmitNullable(out, member);
+    out << "};\n";
+}
+
+void CppEmitter::EmitTerminals(std::ostream& out, layout l) const {
+    out << l.indent
+        << "/// Token IDs of the terminals, the lexer must produce them.\n"
+        << l.indent << "enum terminal : std::uint32_t {\n"
+        << l.indent << "    tk_EPSILON = " << symbol_table::kEpsilon << ",\n"
+        << l.indent << "    tk_EOL = " << symbol_table::kEol << ", // "
+        << Literal(st_.Name(symbol_table::kEol)) << "\n";
+    std::unordered_set<std::string> used{"tk_EPSILON", "tk_EOL"};
+    for (symbol_id t = symbol_table::kEol + 1; t < st_.NumTerminals(); ++t) {
+        std::string enumerator = "tk_" + Identifier(st_.Name(t));
+        if (!used.insert(enumerator).second) {
+            enumerator += "_" + std::to_string(t);
+            used.insert(enumerator);
+        }
+        out << l.indent << "    " << enumerator << " = " << t << ",\n";
+    }
+    out << l.indent << "};\n\n";
+}
+
+void CppEmitter::EmitSymbols(std::ostream& out, layout l) const {
+    const Grammar& gr = parser_.GetGrammar();
+    out << l.indent << l.storage
+        << " std::uint32_t kNumTerminals = " << st_.NumTerminals() << ";\n"
+        << l.indent << l.storage << " std::uint32_t kNumSymbols = "
+        << st_.Size() << ";\n"
+        << l.indent << l.storage << " std::uint32_t kAxiom = " << gr.axiom_
+        << "; // " << st_.Name(gr.axiom_) << "\n\n";
+
+    out << l.indent << "/// Name of every symbol, indexed by ID.\n"
+        << l.indent << l.storage
+        << " const char* kSymbolNames[kNumSymbols] = {\n";
+    for (symbol_id id = 0; id < st_.Size(); ++id) {
+        out << l.indent << "    " << Literal(st_.Name(id)) << ",\n";
+    }
+    out << l.indent << "};\n\n"
+        << l.indent
+        << "/// Regex of every terminal, indexed by ID, to build a lexer.\n"
+        << l.indent << l.storage
+        << " const char* kTerminalRegex[kNumTerminals] = {\n";
+    for (symbol_id t = 0; t < st_.NumTerminals(); ++t) {
+        out << l.indent << "    " << Literal(st_.GetValue(t)) << ",\n";
+    }
+    out << l.indent << "};\n\n";
+}
+
+void CppEmitter::EmitTable(std::ostream& out, layout l) const {
+    std::uint32_t none  = NoProduction(parser_.GetGrammar().NumProductions());
+    bool          narrow{none == std::numeric_limits<std::uint16_t>::max()};
+    int           width = static_cast<int>(std::to_string(none).size());
+    out << l.indent << "/// Production index, kNoProduction if there is none.\n"
+        << l.indent << "using production_id = std::uint" << (narrow ? 16 : 32)
+        << "_t;\n"
+        << l.indent << l.storage << " production_id kNoProduction = " << none
+        << ";\n\n"
+        << l.indent
+        << "/// LL(1) table, one row of kNumTerminals per non-terminal.\n"
+        << l.indent << l.storage << " production_id kTable[] = {";
+    for (symbol_id nt = st_.NumTerminals(); nt < st_.Size(); ++nt) {
+        out << "\n" << l.indent << "    // " << st_.Name(nt);
+        for (symbol_id t = 0; t < st_.NumTerminals(); ++t) {
+            std::uint32_t p = parser_.Prediction(nt, t);
+            if (t % kValuesPerLine == 0) {
+                out << "\n" << l.indent << "   ";
+            }
+            out << " " << std::setw(width)
+                << (p == Grammar::kNoProduction ? none : p) << ",";
+        }
+    }
+    out << "\n" << l.indent << "};\n\n";
+}
+
+void CppEmitter::EmitRules(std::ostream& out, layout l) const {
+    const Grammar& gr = parser_.GetGrammar();
+    out << l.indent << l.storage << " std::uint32_t kNumProductions = "
+        << gr.NumProductions() << ";\n\n"
+        << l.indent
+        << "/// Right-hand side of every production, concatenated (CSR).\n"
+        << l.indent << l.storage << " std::uint32_t kRhs[] = {\n";
+    for (std::uint32_t p = 0; p < gr.NumProductions(); ++p) {
+        out << l.indent << "   ";
+        for (symbol_id symbol : gr.Rhs(p)) {
+            out << " " << symbol << ",";
+        }
+        out << " // " << p << "\n";
+    }
+    out << l.indent << "};\n"
+        << l.indent << "/// Offset of each production in kRhs, plus the end.\n"
+        << l.indent << l.storage << " std::uint32_t kProdOffsets[] = {\n"
+        << l.indent << "    0,";
+    std::size_t offset{0};
+    for (std::uint32_t p = 0; p < gr.NumProductions(); ++p) {
+        offset += gr.Rhs(p).size();
+        if ((p + 1) % kValuesPerLine == 0) {
+            out << "\n" << l.indent << "   ";
+        }
+        out << " " << offset << ",";
+    }
+    out << "\n" << l.indent << "};\n"
+        << l.indent << "/// Left-hand side of every production.\n"
+        << l.indent << l.storage << " std::uint32_t kProdLhs[] = {";
+    for (std::uint32_t p = 0; p < gr.NumProductions(); ++p) {
+        if (p % kValuesPerLine == 0) {
+            out << "\n" << l.indent << "   ";
+        }
+        out << " " << gr.Lhs(p) << ",";
+    }
+    out << "\n" << l.indent << "};\n\n";
+}
+
+void CppEmitter::EmitNullable(std::ostream& out, layout l) const {
+    const Grammar& gr   = parser_.GetGrammar();
+    std::uint32_t  none = NoProduction(gr.NumProductions());
+    out << l.indent
+        << "/// Whether each non-terminal derives the empty string.\n"
+        << l.indent << l.storage << " bool kNullable[] = {";
+    for (symbol_id nt = st_.NumTerminals(); nt < st_.Size(); ++nt) {
+        if (st_.NonTerminalIndex(nt) % kValuesPerLine == 0) {
+            out << "\n" << l.indent << "   ";
+        }
+        out << (gr.IsNullable(nt) ? " true," : " false,");
+    }
+    out << "\n" << l.indent << "};\n"
+        << l.indent
+        << "/// Empty production of each non-terminal, predicted on a\n"
+        << l.indent << "/// table miss, or kNoProduction.\n"
+        << l.indent << l.storage << " production_id kEmptyProduction[] = {";
+    for (symbol_id nt = st_.NumTerminals(); nt < st_.Size(); ++nt) {
+        if (st_.NonTerminalIndex(nt) % kValuesPerLine == 0) {
+            out << "\n" << l.indent << "   ";
+        }
+        out << " "
+            << (gr.HasEmptyProduction(nt) ? gr.EmptyProduction(nt) : none)
+            << ",";
+    }
+    out << "\n" << l.indent << "};\n";
+}
+
+void CppEmitter::EmitProductions(std::ostream& out) const {
+    const Grammar& gr = parser_.GetGrammar();
+    out << "/// Symbols each production pushes onto the stack, in push order\n"
+        << "/// (reversed right-hand side, without EPSILON).\n"
+        << "inline constexpr std::uint32_t kPushOffsets[] = {\n    0,";
+    std::size_t offset{0};
+    for (std::uint32_t p = 0; p < gr.NumProductions(); ++p) {
+        offset += parser_.PushSequence(p).size();
+        out << ((p + 1) % kValuesPerLine == 0 ? "\n    " : " ") << offset
+            << ",";
+    }
+    out << "\n};\n"
+        << "inline constexpr std::uint32_t kPushSymbols[] = {\n";
+    for (std::uint32_t p = 0; p < gr.NumProductions(); ++p) {
+        std::span<const symbol_id> d_symbols = parser_.PushSequence(p);
+        if (d_symbols.empty()) {
+            continue;
+        }
+        out << "   ";
+        for (symbol_id symbol : d_symbols) {
+            out << " " << symbol << ",";
+        }
+        out << " // " << p << "\n";
+    }
+    if (offset == 0) {
+        // Every production is empty, keep the array well-formed
+        out << "    0,\n";
+    }
+    out << "};\n\n"
+        << "/// Whether each non-terminal has an empty production.\n"
+        << "inline constexpr bool kHasEmptyProduction[] = {\n   ";
+    for (symbol_id nt = st_.NumTerminals(); nt < st_.Size(); ++nt) {
+        out << (gr.HasEmptyProduction(nt) ? " true," : " false,");
+        if ((st_.NonTerminalIndex(nt) + 1) % kValuesPerLine == 0 &&
+            nt + 1 < st_.Size()) {
+            out << "\n   ";
+        }
+    }
+    out << "\n};\n";
+}
+
+std::string CppEmitter::Identifier(std::string_view name) {
+    std::string identifier(name);
+    for (char& c : identifier) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+            c = '_';
+        }
+    }
+    return identifier;
+}
+
+std::string CppEmitter::Literal(std::string_view text) {
+    std::string literal{"\""};
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            literal += '\\';
+            literal += c;
+        } else if (std::isprint(static_cast<unsigned char>(c))) {
+            literal += c;
+        } else {
+            char escaped[5];
+            std::snprintf(escaped, sizeof(escaped), "\\%03o",
+                          static_cast<unsigned char>(c));
+            literal += escaped;
+        }
+    }
+    return literal + "\"";
+}
@@ -1,9 +1,12 @@
 #include "../include/grammar.hpp"
 #include "../include/grammar_error.hpp"
 #include "../include/symbol_table.hpp"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <ranges>
 #include <regex>
+#include <span>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -21,6 +24,8 @@ void Grammar::ReadFromFile() {
     }
 
     std::unordered_map<std::string, std::vector<std::string>> p_grammar;
+    std::vector<std::string>                                  antecedents;
+    std::string                                               axiom;
     std::regex                                                rx_terminal{
         R"(terminal\s+([a-zA-Z_\'][a-zA-Z_0-9\']*)\s+([^]*);\s*)"};
     std::regex rx_eol{R"(set\s+EOL\s+char\s+([^]*);\s*)"};
@@ -41,11 +46,11 @@ void Grammar::ReadFromFile() {
             std::string value;
 
             if (std::regex_match(input, match, rx_terminal)) {
-                symbol_table::PutSymbol(match[1], match[2]);
+                st_.PutSymbol(match[1], match[2]);
             } else if (std::regex_match(input, match, rx_axiom)) {
-                SetAxiom(match[1]);
+                axiom = match[1];
             } else if (std::regex_match(input, match, rx_eol)) {
-                symbol_table::SetEol(match[1]);
+                st_.SetEol(match[1]);
             } else {
                 throw GrammarError("Error while reading tokens " + input);
             }
@@ -55,9 +60,17 @@ void Grammar::ReadFromFile() {
             if (std::regex_match(input, match, rx_production)) {
                 std::string s = match[2];
                 s.erase(std::remove_if(s.begin(), s.end(), ::isspace), s.end());
-                p_grammar[match[1]].push_back(s);
+                auto& rules = p_grammar[match[1]];
+                if (rules.empty()) {
+                    antecedents.push_back(match[1]);
+                }
+                rules.push_back(s);
             } else if (std::regex_match(input, match, rx_empty_production)) {
-                p_grammar[match[1]].push_back(symbol_table::EPSILON_);
+                auto& rules = p_grammar[match[1]];
+                if (rules.empty()) {
+                    antecedents.push_back(match[1]);
+                }
+                rules.push_back(symbol_table::EPSILON_);
 
             } else {
                 throw GrammarError("Error while reading grammar " + input);
@@ -71,40 +84,49 @@ void Grammar::ReadFromFile() {
     }
     file.close();
 
-    // Add non terminal symbols
-    for (const auto& entry : p_grammar) {
-        symbol_table::PutSymbol(entry.first);
+    // Add non terminal symbols, in order of first appearance
+    for (const std::string& antecedent : antecedents) {
+        st_.PutSymbol(antecedent);
     }
 
+    if (!st_.In(axiom) ||
+        st_.IsTerminal(st_.Id(axiom))) {
+        throw GrammarError("Axiom " + axiom + " has no productions");
+    }
+    SetAxiom(st_.Id(axiom));
+
     // Add all rules
-    for (const auto& entry : p_grammar) {
-        for (const auto& prod : entry.second) {
-            AddRule(entry.first, prod);
+    for (const std::string& antecedent : antecedents) {
+        symbol_id id{st_.Id(antecedent)};
+        for (const auto& prod : p_grammar.at(antecedent)) {
+            AddRule(id, prod);
         }
     }
+
+    ComputeNullable();
 }
 
-std::vector<std::string> Grammar::Split(const std::string& s) {
+production Grammar::Split(const std::string& s) const {
     if (s == symbol_table::EPSILON_) {
-        return {symbol_table::EPSILON_};
+        return {symbol_table::kEpsilon};
     }
-    std::vector<std::string> splitted{};
-    std::string              str;
-    unsigned                 start{0};
-    unsigned                 end{1};
+    production  splitted{};
+    std::string str;
+    unsigned    start{0};
+    unsigned    end{1};
     while (end <= s.size()) {
         str = s.substr(start, end - start);
 
-        if (symbol_table::In(str)) {
+        if (st_.In(str)) {
             unsigned lookahead = end + 1;
             while (lookahead <= s.size()) {
                 std::string extended = s.substr(start, lookahead - start);
-                if (symbol_table::In(extended)) {
+                if (st_.In(extended)) {
                     end = lookahead;
                 }
                 ++lookahead;
             }
-            splitted.push_back(s.substr(start, end - start));
+            splitted.push_back(st_.Id(s.substr(start, end - start)));
             start = end;
             end   = start + 1;
         } else {
@@ -120,76 +142,130 @@ std::vector<std::string> Grammar::Split(const std::string& s) {
     return splitted;
 }
 
-void Grammar::AddRule(const std::string& antecedent,
-                      const std::string& consequent) {
-    std::vector<std::string> splitted_consequent{Split(consequent)};
-    g_[antecedent].push_back(splitted_consequent);
+void Grammar::AddRule(symbol_id antecedent, const std::string& consequent) {
+    size_t nt{st_.NonTerminalIndex(antecedent)};
+    if (nt + 2 < nt_offsets_.size()) {
+        throw GrammarError("Rules of " + st_.Name(antecedent) +
+                           " must be added together");
+    }
+    while (nt_offsets_.size() < nt + 2) {
+        nt_offsets_.push_back(nt_offsets_.back());
+    }
+    production splitted_consequent{Split(consequent)};
+    rhs_.insert(rhs_.end(), splitted_consequent.cbegin(),
+                splitted_consequent.cend());
+    prod_offsets_.push_back(static_cast<std::uint32_t>(rhs_.size()));
+    prod_lhs_.push_back(antecedent);
+    nt_offsets_.back() = NumProductions();
 }
 
-void Grammar::SetAxiom(const std::string& axiom) {
+void Grammar::SetAxiom(symbol_id axiom) {
     axiom_ = axiom;
 }
 
-bool Grammar::HasEmptyProduction(const std::string& antecedent) {
-    auto rules{g_.at(antecedent)};
-    return std::find_if(rules.cbegin(), rules.cend(), [](const auto& rule) {
-               return rule[0] == symbol_table::EPSILON_;
-           }) != rules.cend();
-}
+void Grammar::ComputeNullable() {
+    size_t n{st_.NumNonTerminals()};
+    nullable_.assign(n, false);
+    empty_production_.assign(n, kNoProduction);
 
-std::vector<std::pair<const std::string, production>>
-Grammar::FilterRulesByConsequent(const std::string& arg) {
-    std::vector<std::pair<const std::string, production>> rules;
-    for (const std::pair<const std::string, std::vector<production>>& rule :
-         g_) {
-        for (const production& prod : rule.second) {
-            if (std::find(prod.cbegin(), prod.cend(), arg) != prod.cend()) {
-                rules.emplace_back(rule.first, prod);
-            }
+    // Non-terminals each production still needs to be nullable, and the
+    // productions waiting on each non-terminal, once per occurrence
+    std::vector<std::uint32_t>              pending(NumProductions(), 0);
+    std::vector<std::vector<std::uint32_t>> waiting(n);
+    std::vector<symbol_id>                  worklist;
+
+    auto mark_nullable = [&](symbol_id nt) {
+        if (!nullable_[st_.NonTerminalIndex(nt)]) {
+            nullable_[st_.NonTerminalIndex(nt)] = true;
+            worklist.push_back(nt);
         }
-    }
-    return rules;
-}
+    };
 
-void Grammar::Debug() {
-    std::cout << "Grammar:\n";
+    for (std::uint32_t p = 0; p < NumProductions(); ++p) {
+        std::span<const symbol_id> rhs{Rhs(p)};
+        auto eol = std::find(rhs.begin(), rhs.end(), symbol_table::kEol);
+        std::span<const symbol_id> prefix{rhs.begin(), eol};
 
-    std::cout << axiom_ << " -> ";
-    const auto& axiom_productions = g_.at(axiom_);
-    for (size_t i = 0; i < axiom_productions.size(); ++i) {
-        for (const std::string& symbol : axiom_productions[i]) {
-            std::cout << symbol << " ";
+        if (std::ranges::any_of(prefix, [this](symbol_id symbol) {
+                return symbol != symbol_table::kEpsilon &&
+                       st_.IsTerminal(symbol);
+            })) {
+            continue;
+        }
+        if (rhs.size() == 1 && rhs[0] == symbol_table::kEpsilon &&
+            !HasEmptyProduction(Lhs(p))) {
+            empty_production_[st_.NonTerminalIndex(Lhs(p))] = p;
+        }
+        for (symbol_id symbol : prefix) {
+            if (symbol != symbol_table::kEpsilon) {
+                ++pending[p];
+                waiting[st_.NonTerminalIndex(symbol)].push_back(p);
+            }
         }
-        if (i < axiom_productions.size() - 1) {
-            std::cout << "| ";
+        if (pending[p] == 0) {
+            mark_nullable(Lhs(p));
         }
     }
-    std::cout << "\n";
 
-    std::vector<std::string> non_terminals;
-    for (const auto& entry : g_) {
-        if (entry.first != axiom_) {
-            non_terminals.push_back(entry.first);
+    while (!worklist.empty()) {
+        symbol_id nt = worklist.back();
+        worklist.pop_back();
+        for (std::uint32_t p : waiting[st_.NonTerminalIndex(nt)]) {
+            if (--pending[p] == 0) {
+                mark_nullable(Lhs(p));
+            }
         }
     }
+}
 
-    std::sort(non_terminals.begin(), non_terminals.end());
+std::vector<std::uint32_t> Grammar::FilterRulesByConsequent(symbol_id arg) {
+    std::vector<std::uint32_t> rules;
+    for (std::uint32_t p = 0; p < NumProductions(); ++p) {
+        std::span<const symbol_id> prod{Rhs(p)};
+        if (std::find(prod.begin(), prod.end(), arg) != prod.end()) {
+            rules.push_back(p);
+        }
+    }
+    return rules;
+}
 
-    for (const std::string& nt : non_terminals) {
-        std::cout << nt << " -> ";
-        const auto& productions = g_.at(nt);
-        for (size_t i = 0; i < productions.size(); ++i) {
-            for (const std::string& symbol : productions[i]) {
-                std::cout << symbol << " ";
+void Grammar::Debug() {
+    std::cout << "Grammar:\n";
+
+    auto print_productions = [this](symbol_id nt) {
+        std::cout << st_.Name(nt) << " -> ";
+        auto productions = Productions(nt);
+        for (std::uint32_t p : productions) {
+            for (symbol_id symbol : Rhs(p)) {
+                std::cout << st_.Name(symbol) << " ";
             }
-            if (i < productions.size() - 1) {
+            if (p != productions.back()) {
                 std::cout << "| ";
             }
         }
         std::cout << "\n";
+    };
+
+    print_productions(axiom_);
+
+    std::vector<symbol_id> non_terminals;
+    for (symbol_id nt = st_.NumTerminals(); nt < st_.Size(); ++nt) {
+        if (nt != axiom_) {
+            non_terminals.push_back(nt);
+        }
+    }
+
+    std::sort(non_terminals.begin(), non_terminals.end(),
+              [this](symbol_id a, symbol_id b) {
+                  return st_.Name(a) < st_.Name(b);
+              });
+
+    for (symbol_id nt : non_terminals) {
+        print_productions(nt);
     }
 }
-bool Grammar::HasLeftRecursion(const std::string&              antecedent,
-                               const std::vector<std::string>& consequent) {
-    return consequent.at(0) == antecedent;
+
+bool Grammar::HasLeftRecursion(symbol_id                  antecedent,
+                               std::span<const symbol_id> consequent) {
+    return !consequent.empty() && consequent[0] == antecedent;
 }
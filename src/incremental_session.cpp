@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../include/grammar.hpp"
+#include "../include/incremental_session.hpp"
+#include "../include/lexer.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/symbol_table.hpp"
+
+void IncrementalSession::block_sums::Build(
+    const std::vector<std::size_t>& sizes) {
+    tree_.assign(sizes.size() + 1, 0);
+    total_ = 0;
+    for (std::size_t i = 1; i < tree_.size(); ++i) {
+        tree_[i] += sizes[i - 1];
+        total_ += sizes[i - 1];
+        std::size_t parent = i + (i & -i);
+        if (parent < tree_.size()) {
+            tree_[parent] += tree_[i];
+        }
+    }
+}
+
+void IncrementalSession::block_sums::Add(std::size_t i, std::size_t delta) {
+    total_ += delta;
+    for (std::size_t j = i + 1; j < tree_.size(); j += j & -j) {
+        tree_[j] += delta;
+    }
+}
+
+std::size_t IncrementalSession::block_sums::Before(std::size_t i) const {
+    std::size_t sum{0};
+    for (std::size_t j = i; j > 0; j -= j & -j) {
+        sum += tree_[j];
+    }
+    return sum;
+}
+
+std::size_t IncrementalSession::block_sums::Find(std::size_t offset) const {
+    // Number of blocks whose end is at or before `offset`
+    std::size_t count{0};
+    for (std::size_t step = std::bit_floor(tree_.size() - 1); step > 0;
+         step >>= 1) {
+        if (count + step < tree_.size() && tree_[count + step] <= offset) {
+            count += step;
+            offset -= tree_[count];
+        }
+    }
+    return std::min(count, tree_.size() - 2);
+}
+
+IncrementalSession::IncrementalSession(const LL1Parser& parser)
+    : parser_(parser), gr_(parser.GetGrammar()), lex_(gr_.st_) {
+    Load({});
+}
+
+bool IncrementalSession::Load(std::string_view text) {
+    block whole;
+    whole.text = text;
+    LexText(whole.text, 0, whole.tokens, whole.ranges);
+    whole.stack        = {gr_.axiom_};
+    whole.has_snapshot = true;
+
+    blocks_.clear();
+    Cut(std::move(whole), blocks_);
+    IndexBlocks();
+    outcomes_.clear();
+    Resume(0);
+    return Accepted();
+}
+
+bool IncrementalSession::Edit(std::size_t offset, std::size_t length,
+                              std::string_view replacement) {
+    if (offset > Size()) {
+        throw std::out_of_range("Edit offset past the end of the text");
+    }
+    length = std::min(length, Size() - offset);
+
+    // Lex again the whole lines touched by the edit, tokens do not cross them
+    std::size_t  e1 = bytes_.Find(offset);
+    std::size_t  e2 = bytes_.Find(offset + length);
+    const block& first_block = blocks_[e1];
+    const block& last_block  = blocks_[e2];
+    std::size_t  head        = offset - bytes_.Before(e1);
+    std::size_t  tail        = offset + length - bytes_.Before(e2);
+    std::size_t  begin =
+        head == 0 ? 0 : first_block.text.rfind('\n', head - 1) + 1;
+    std::size_t end = last_block.text.find('\n', tail);
+    end = end == std::string::npos ? last_block.text.size() : end + 1;
+    std::string window;
+    window.reserve(head - begin + replacement.size() + end - tail);
+    window.append(first_block.text, begin, head - begin)
+        .append(replacement)
+        .append(last_block.text, tail, end - tail);
+    block edited;
+    std::vector<symbol_id>   tokens;
+    std::vector<token_range> ranges;
+    LexText(window, begin, tokens, ranges);
+
+    // The edited block: the untouched lines around the window keep their
+    // tokens, those after it shifted to their new place
+    edited.text.reserve(head + replacement.size() + last_block.text.size() -
+                        tail);
+    edited.text.append(first_block.text, 0, head)
+        .append(replacement)
+        .append(last_block.text, tail);
+    auto by_begin = [](const token_range& range, std::size_t o) {
+        return range.begin < o;
+    };
+    std::size_t kept_head =
+        std::lower_bound(first_block.ranges.begin(), first_block.ranges.end(),
+                         begin, by_begin) -
+        first_block.ranges.begin();
+    std::size_t kept_tail =
+        std::lower_bound(last_block.ranges.begin(), last_block.ranges.end(),
+                         end, by_begin) -
+        last_block.ranges.begin();
+    edited.tokens.assign(first_block.tokens.begin(),
+                         first_block.tokens.begin() + kept_head);
+    edited.tokens.insert(edited.tokens.end(), tokens.begin(), tokens.end());
+    edited.tokens.insert(edited.tokens.end(),
+                         last_block.tokens.begin() + kept_tail,
+                         last_block.tokens.end());
+    edited.ranges.assign(first_block.ranges.begin(),
+                         first_block.ranges.begin() + kept_head);
+    edited.ranges.insert(edited.ranges.end(), ranges.begin(), ranges.end());
+    std::size_t moved_to = head + replacement.size();
+    for (std::size_t i = kept_tail; i < last_block.ranges.size(); ++i) {
+        token_range range = last_block.ranges[i];
+        edited.ranges.push_back({range.begin - tail + moved_to,
+                                 range.end - tail + moved_to});
+    }
+    std::size_t old_bytes  = first_block.text.size();
+    std::size_t old_tokens = first_block.tokens.size();
+    edited.stack           = std::move(blocks_[e1].stack);
+    edited.has_snapshot    = blocks_[e1].has_snapshot;
+    std::vector<block> pieces;
+    Cut(std::move(edited), pieces);
+
+    // Renumber the outcomes past the edit. An earlier parse that went
+    // through the edited blocks no longer holds from any snapshot before it
+    bool        resume  = outcomes_.front().stop.block >= e1;
+    std::size_t new_end = e1 + pieces.size();
+    for (outcome& o : outcomes_) {
+        if (o.stop.block > e2) {
+            o.stop.block = o.stop.block - (e2 + 1) + new_end;
+        } else if (o.stop.block >= e1) {
+            o.stop = {e1, 0};
+        }
+        if (o.valid_from > e2) {
+            o.valid_from = o.valid_from - (e2 + 1) + new_end;
+        } else if (o.valid_from > e1) {
+            o.valid_from = new_end;
+        }
+    }
+    outcomes_.erase(std::unique(outcomes_.begin(), outcomes_.end(),
+                                [](const outcome& a, const outcome& b) {
+                                    return a.stop == b.stop;
+                                }),
+                    outcomes_.end());
+    if (!resume) {
+        auto through = std::ranges::find_if(outcomes_, [e1](const outcome& o) {
+            return o.stop >= position{e1, 0};
+        });
+        if (through != outcomes_.end()) {
+            through->valid_from = std::max(through->valid_from, new_end);
+        }
+    }
+
+    if (e1 == e2 && pieces.size() == 1) {
+        bytes_.Add(e1, pieces[0].text.size() - old_bytes);
+        num_tokens_.Add(e1, pieces[0].tokens.size() - old_tokens);
+        blocks_[e1] = std::move(pieces[0]);
+    } else {
+        blocks_.erase(blocks_.begin() + e1 + 1, blocks_.begin() + e2 + 1);
+        blocks_[e1] = std::move(pieces[0]);
+        blocks_.insert(blocks_.begin() + e1 + 1,
+                       std::make_move_iterator(pieces.begin() + 1),
+                       std::make_move_iterator(pieces.end()));
+        IndexBlocks();
+    }
+
+    if (!resume) {
+        // The parse stopped before the edit, its result holds
+        parsed_tokens_ = 0;
+    } else {
+        Resume(e1);
+    }
+    return Accepted();
+}
+
+std::string IncrementalSession::Text() const {
+    std::string text;
+    text.reserve(Size());
+    for (const block& b : blocks_) {
+        text += b.text;
+    }
+    return text;
+}
+
+std::size_t IncrementalSession::ErrorOffset() const {
+    position stop = outcomes_.front().stop;
+    return bytes_.Before(stop.block) +
+           blocks_[stop.block].ranges[stop.token].begin;
+}
+
+void IncrementalSession::LexText(std::string_view text, std::size_t offset,
+                                 std::vector<symbol_id>&   tokens,
+                                 std::vector<token_range>& ranges) {
+    lex_.Reset(text);
+    lex_.TrackRanges(true);
+    for (auto chunk = lex_.NextChunk(); !chunk.empty();
+         chunk      = lex_.NextChunk()) {
+        tokens.insert(tokens.end(), chunk.begin(), chunk.end());
+        for (token_range range : lex_.Ranges()) {
+            ranges.push_back({range.begin + offset, range.end + offset});
+        }
+    }
+}
+
+void IncrementalSession::Cut(block whole, std::vector<block>& pieces) {
+    std::size_t token{0}, byte{0};
+    while (whole.tokens.size() - token > 2 * kCheckpointInterval) {
+        std::size_t newline = whole.text.find(
+            '\n', whole.ranges[token + kCheckpointInterval - 1].end);
+        if (newline == std::string::npos) {
+            break;
+        }
+        std::size_t cut  = newline + 1;
+        auto        next = std::lower_bound(
+            whole.ranges.begin() + token + kCheckpointInterval,
+            whole.ranges.end(), cut,
+            [](const token_range& range, std::size_t o) {
+                return range.begin < o;
+            });
+        std::size_t until = next - whole.ranges.begin();
+        block       piece;
+        piece.text = whole.text.substr(byte, cut - byte);
+        piece.tokens.assign(whole.tokens.begin() + token,
+                            whole.tokens.begin() + until);
+        for (std::size_t i = token; i < until; ++i) {
+            piece.ranges.push_back(
+                {whole.ranges[i].begin - byte, whole.ranges[i].end - byte});
+        }
+        if (token == 0) {
+            piece.stack        = std::move(whole.stack);
+            piece.has_snapshot = whole.has_snapshot;
+        }
+        pieces.push_back(std::move(piece));
+        token = until;
+        byte  = cut;
+    }
+    if (token == 0) {
+        pieces.push_back(std::move(whole));
+        return;
+    }
+    block rest;
+    rest.text = whole.text.substr(byte);
+    rest.tokens.assign(whole.tokens.begin() + token, whole.tokens.end());
+    for (std::size_t i = token; i < whole.ranges.size(); ++i) {
+        rest.ranges.push_back(
+            {whole.ranges[i].begin - byte, whole.ranges[i].end - byte});
+    }
+    pieces.push_back(std::move(rest));
+}
+
+void IncrementalSession::IndexBlocks() {
+    std::vector<std::size_t> bytes, tokens;
+    bytes.reserve(blocks_.size());
+    tokens.reserve(blocks_.size());
+    for (const block& b : blocks_) {
+        bytes.push_back(b.text.size());
+        tokens.push_back(b.tokens.size());
+    }
+    bytes_.Build(bytes);
+    num_tokens_.Build(tokens);
+}
+
+void IncrementalSession::Resume(std::size_t first) {
+    symbol_id    num_terminals{gr_.st_.NumTerminals()};
+    parse_status status{RUNNING};
+    bool         converged{false};
+    position     pos{first, 0};
+    stack_         = blocks_[first].stack;
+    next_outcome_  = 0;
+    parsed_tokens_ = 0;
+    for (std::size_t b = first; b < blocks_.size(); ++b) {
+        if (b != first) {
+            if (Converges(b)) {
+                converged = true;
+                pos       = {b, 0};
+                break;
+            }
+            blocks_[b].stack        = stack_;
+            blocks_[b].has_snapshot = true;
+        }
+        const std::vector<symbol_id>& tokens = blocks_[b].tokens;
+        std::size_t                   k{0};
+        while (k < tokens.size()) {
+            if (stack_.empty()) {
+                status = ACCEPTED;
+                break;
+            }
+            symbol_id top_symbol = stack_.back();
+            stack_.pop_back();
+            if (top_symbol < num_terminals) {
+                if (top_symbol != tokens[k]) {
+                    status = REJECTED;
+                    break;
+                }
+                ++k;
+                continue;
+            }
+            std::uint32_t production =
+                parser_.Prediction(top_symbol, tokens[k]);
+            if (production != Grammar::kNoProduction) {
+                std::span<const symbol_id> d_symbols =
+                    parser_.PushSequence(production);
+                stack_.insert(stack_.end(), d_symbols.begin(),
+                              d_symbols.end());
+            } else if (!gr_.HasEmptyProduction(top_symbol)) {
+                status = REJECTED;
+                break;
+            }
+        }
+        parsed_tokens_ += k;
+        pos = {b, k};
+        if (status != RUNNING) {
+            break;
+        }
+    }
+
+    if (converged) {
+        // The rest of the earlier parse still holds, from every snapshot
+        std::erase_if(outcomes_,
+                      [pos](const outcome& o) { return o.stop < pos; });
+        outcomes_.front().valid_from = 0;
+    } else {
+        std::erase_if(outcomes_,
+                      [pos](const outcome& o) { return o.stop <= pos; });
+        outcomes_.insert(outcomes_.begin(), {status, pos, 0});
+    }
+}
+
+bool IncrementalSession::Converges(std::size_t b) {
+    while (next_outcome_ < outcomes_.size() &&
+           outcomes_[next_outcome_].stop < position{b, 0}) {
+        ++next_outcome_;
+    }
+    return blocks_[b].has_snapshot && next_outcome_ < outcomes_.size() &&
+           b >= outcomes_[next_outcome_].valid_from &&
+           blocks_[b].stack == stack_;
+}
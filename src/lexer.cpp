@@ -1,61 +1,167 @@
 #include "../include/lexer.hpp"
 #include "../include/lexer_error.hpp"
 #include "../include/symbol_table.hpp"
+#include <algorithm>
 #include <boost/bind/bind.hpp>
 #include <boost/ref.hpp>
 #include <boost/spirit/include/lex_lexertl.hpp>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <span>
 #include <string>
+#include <string_view>
 
-Lex::Lex(std::string filename) : filename_(std::move(filename)), current_() {
-    Tokenize();
+Lex::Lex(const symbol_table& st, const std::string& filename)
+    : st_(st), lexer_(st), file_(filename) {}
+
+Lex::Lex(const symbol_table& st) : st_(st), lexer_(st) {}
+
+void Lex::Open(const std::string& filename) {
+    Reset({});
+    file_.open(filename);
+    if (!file_) {
+        throw LexerError("Cannot open input file " + filename);
+    }
 }
 
-template <typename Lexer> Lex::ParseInput<Lexer>::ParseInput() {
-    unsigned long i{1};
-    std::string   token_type{symbol_table::token_types_r_.at(i)};
-    this->self.add("\\" + symbol_table::EOL_, i);
-    ++i;
-    for (size_t j = 1; j < symbol_table::order_.size(); ++j) {
-        token_type = symbol_table::token_types_r_.at(i);
-        std::string regex{symbol_table::st_.at(token_type).second};
-        this->self.add(regex, i);
-        ++i;
+void Lex::Reset(std::string_view text) {
+    file_.close();
+    file_.clear();
+    buffer_.clear();
+    held_   = 0;
+    text_   = text;
+    offset_ = 0;
+    tokens_.clear();
+    ranges_.clear();
+    current_ = 0;
+}
+
+template <typename Lexer>
+Lex::ParseInput<Lexer>::ParseInput(const symbol_table& st) {
+    this->self.add("\\" + st.EOL_, symbol_table::kEol);
+    symbol_id i{symbol_table::kEol + 1};
+    for (; i < st.NumTerminals(); ++i) {
+        this->self.add(st.GetValue(i), i);
     }
+    // Whitespace takes the first ID past the terminals and is skipped by Add
     this->self.add("[ \\t\\n]+", i);
 }
 
 template <typename Token>
-bool Lex::Add::operator()(Token const& t, std::vector<std::string>& tks) const {
-    if (static_cast<unsigned long>(t.id()) == symbol_table::i_) {
+bool Lex::Add::operator()(Token const& t, std::vector<symbol_id>& tks) const {
+    auto id      = static_cast<symbol_id>(t.id());
+    last->begin    = t.value().begin();
+    last->end      = t.value().end();
+    last->is_token = id != skip_id;
+    if (id == skip_id) {
         return true;
     }
-    tks.push_back(
-        symbol_table::token_types_r_.at(static_cast<unsigned long>(t.id())));
+    tks.push_back(id);
+    if (ranges != nullptr) {
+        ranges->push_back({offset + (t.value().begin() - chunk),
+                           offset + (t.value().end() - chunk)});
+    }
     return true;
 }
 
-void Lex::Tokenize() {
-    ParseInput<boost::spirit::lex::lexertl::lexer<>> functor;
+std::size_t Lex::Tokenize(std::string_view chunk, bool final) {
     using boost::placeholders::_1;
-    std::ifstream      file(filename_);
-    std::ostringstream buffer;
-    buffer << file.rdbuf();
-    std::string input     = buffer.str();
-    char const* first     = input.c_str();
-    char const* end       = &first[input.size()];
+    char const* first = chunk.data();
+    char const* end   = first + chunk.size();
+    last_lexeme last;
     bool        completed = boost::spirit::lex::tokenize(
-        first, end, functor, boost::bind(Add(), _1, boost::ref(tokens_)));
-    if (!completed) {
-        std::string rest(first, end);
+        first, end, lexer_,
+        boost::bind(Add{st_.NumTerminals(),
+                        track_ranges_ ? &ranges_ : nullptr, chunk.data(),
+                        offset_, &last},
+                    _1, boost::ref(tokens_)));
+    // Invalid bytes followed by more than a token cannot start a valid one
+    if (!completed &&
+        (final || static_cast<std::size_t>(end - first) > kMaxTokenSize)) {
+        std::string rest(first, std::min<std::size_t>(end - first, kChunkSize));
         throw LexerError("Lexical error: encountered an invalid token:\n" +
                          rest);
     }
+    if (final) {
+        return chunk.size();
+    }
+
+    // The last token may go on in the next bytes, lex it again with them
+    char const* cut = first;
+    if (last.is_token && last.end == cut) {
+        tokens_.pop_back();
+        if (track_ranges_) {
+            ranges_.pop_back();
+        }
+        cut = last.begin;
+    }
+    std::size_t size = cut - chunk.data();
+    if (size == 0 && chunk.size() > kMaxTokenSize) {
+        throw LexerError("Lexical error: token longer than " +
+                         std::to_string(kMaxTokenSize) + " bytes");
+    }
+    return size;
+}
+
+std::string_view Lex::NextText(bool& final) {
+    if (!file_.is_open()) {
+        std::string_view chunk = text_.substr(0, held_ + kChunkSize);
+        final                  = chunk.size() == text_.size();
+        return chunk;
+    }
+
+    std::size_t old_size = buffer_.size();
+    buffer_.resize(old_size + kChunkSize);
+    file_.read(buffer_.data() + old_size, kChunkSize);
+    buffer_.resize(old_size + file_.gcount());
+    final = !file_;
+    return buffer_;
+}
+
+void Lex::Consume(std::size_t size, std::size_t chunk_size) {
+    if (file_.is_open()) {
+        buffer_.erase(0, size);
+    } else {
+        text_.remove_prefix(size);
+    }
+    held_ = chunk_size - size;
+    offset_ += size;
+}
+
+std::span<const symbol_id> Lex::NextChunk() {
+    tokens_.clear();
+    ranges_.clear();
+    while (tokens_.empty()) {
+        bool             final{false};
+        std::string_view chunk = NextText(final);
+        if (chunk.empty()) {
+            break;
+        }
+        Consume(Tokenize(chunk, final), chunk.size());
+    }
+    current_ = tokens_.size();
+    return tokens_;
+}
+
+std::span<const symbol_id> Lex::Feed(std::string_view text, bool final,
+                                     std::size_t& size) {
+    tokens_.clear();
+    ranges_.clear();
+    size = Tokenize(text, final);
+    offset_ += size;
+    current_ = tokens_.size();
+    return tokens_;
 }
 
-std::string Lex::Next() {
-    return current_ >= tokens_.size() ? "" : tokens_[current_++];
-}
\ No newline at end of file
+symbol_id Lex::Next() {
+    if (current_ == tokens_.size()) {
+        if (NextChunk().empty()) {
+            return symbol_table::kNone;
+        }
+        current_ = 0;
+    }
+    return tokens_[current_++];
+}
@@ -1,35 +1,24 @@
 #include <algorithm>
 #include <cstddef>
 #include <iostream>
+#include <limits>
 #include <ranges>
 #include <span>
-#include <stack>
 #include <string>
+#include <thread>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 
 #include "../include/grammar.hpp"
 #include "../include/grammar_error.hpp"
-#include "../include/lexer.hpp"
 #include "../include/ll1_parser.hpp"
 #include "../include/symbol_table.hpp"
 #include "../include/tabulate.hpp"
+#include "../include/terminal_set.hpp"
+#include "../include/work_stealing_pool.hpp"
 
-LL1Parser::LL1Parser(Grammar gr, std::string text_file, bool table_format)
-    : gr_(std::move(gr)), text_file_(std::move(text_file)),
-      print_table_format_(table_format) {
-    if (!CreateLL1Table()) {
-        gr_.Debug();
-        PrintTable();
-        throw GrammarError("Grammar provided is not LL1.");
-    }
-}
-
-LL1Parser::LL1Parser(const std::string& grammar_file, std::string text_file,
-                     bool table_format)
-    : gr_(grammar_file), text_file_(std::move(text_file)),
-      print_table_format_(table_format) {
+LL1Parser::LL1Parser(Grammar gr, bool table_format)
+    : gr_(std::move(gr)), print_table_format_(table_format) {
     if (!CreateLL1Table()) {
         gr_.Debug();
         PrintTable();
@@ -48,247 +37,327 @@ LL1Parser::LL1Parser(const std::string& grammar_file, bool table_format)
 
 bool LL1Parser::CreateLL1Table() {
     ComputeFirstSets();
+    ComputeSuffixFirstSets();
     ComputeFollowSets();
+    CompilePushSequences();
+
+    symbol_id first_nt{gr_.st_.NumTerminals()};
+    size_t    nrows{gr_.st_.NumNonTerminals()};
+    ll1_t_.assign(nrows * gr_.st_.NumTerminals(), ll1_cell{});
+    conflicts_.clear();
+
+    size_t nblocks{std::max<size_t>(nrows / kMinRowsPerTask, 1)};
+    std::vector<conflict_map> conflicts(nblocks);
+    std::vector<char>         ok(nblocks);
+    auto fill_block = [&](size_t block) {
+        auto row = [&](size_t b) {
+            return static_cast<symbol_id>(first_nt + nrows * b / nblocks);
+        };
+        ok[block] = FillRows(row(block), row(block + 1), conflicts[block]);
+    };
+
+    if (nblocks == 1) {
+        fill_block(0);
+    } else {
+        // Each build has its own pool, so builds of several grammars on
+        // different threads do not wait on each other
+        size_t hw = std::max(1U, std::thread::hardware_concurrency());
+        WorkStealingPool pool(static_cast<unsigned>(std::min(nblocks, hw)));
+        pool.Run(nblocks, [&](unsigned, std::size_t block) {
+            fill_block(block);
+        });
+    }
 
-    size_t nrows{gr_.g_.size()};
-    ll1_t_.reserve(nrows);
+    for (conflict_map& block_conflicts : conflicts) {
+        conflicts_.merge(block_conflicts);
+    }
+    return std::ranges::all_of(ok, [](char block_ok) { return block_ok; });
+}
+
+bool LL1Parser::FillRows(symbol_id first, symbol_id last,
+                         conflict_map& conflicts) {
     bool has_conflict{false};
-    for (const auto& rule : gr_.g_) {
-        std::unordered_map<std::string, std::vector<production>> column;
-        for (const production& p : rule.second) {
-            std::unordered_set<std::string> ds =
-                PredictionSymbols(rule.first, p);
-            column.reserve(ds.size());
-            for (const std::string& symbol : ds) {
-                auto& cell = column[symbol];
-                if (!cell.empty()) {
-                    has_conflict = true;
-                }
-                cell.push_back(p);
+    for (symbol_id nt = first; nt < last; ++nt) {
+        TerminalSet predicted(gr_.st_.NumTerminals());
+        for (std::uint32_t i : gr_.Productions(nt)) {
+            TerminalSet ds = PredictionSymbols(i);
+            if (!ds.Intersects(predicted)) {
+                predicted.Merge(ds);
+                ds.ForEach([&](symbol_id symbol) {
+                    ll1_t_[CellIndex(nt, symbol)].production = i;
+                });
+                continue;
             }
+            // Slow path, only for grammars that are not LL(1)
+            has_conflict = true;
+            predicted.Merge(ds);
+            ds.ForEach([&](symbol_id symbol) {
+                size_t    idx{CellIndex(nt, symbol)};
+                ll1_cell& cell = ll1_t_[idx];
+                if (cell.production == Grammar::kNoProduction) {
+                    cell.production = i;
+                    return;
+                }
+                auto& conflict = conflicts[idx];
+                if (!cell.conflict) {
+                    cell.conflict = 1;
+                    conflict.push_back(cell.production);
+                }
+                conflict.push_back(i);
+            });
         }
-        ll1_t_.insert({rule.first, column});
     }
     return !has_conflict;
 }
 
-void LL1Parser::PrintStackTrace() {
-    std::cout << "Parser stack trace : [ ";
-    while (!symbol_stack_.empty()) {
-        std::cout << symbol_stack_.top() << " ";
-        symbol_stack_.pop();
+void LL1Parser::CompilePushSequences() {
+    push_symbols_.clear();
+    push_symbols_.reserve(gr_.rhs_.size());
+    push_offsets_.assign(1, 0);
+    for (std::uint32_t p = 0; p < gr_.NumProductions(); ++p) {
+        for (symbol_id symbol : std::ranges::reverse_view(gr_.Rhs(p))) {
+            if (symbol != symbol_table::kEpsilon) {
+                push_symbols_.push_back(symbol);
+            }
+        }
+        push_offsets_.push_back(
+            static_cast<std::uint32_t>(push_symbols_.size()));
     }
-    std::cout << "]\n";
 }
 
-void LL1Parser::PrintSymbolHist() {
-    std::cout << "Last 5 processed symbols : [ ";
-    while (!trace_.empty()) {
-        std::cout << trace_.front() << " ";
-        trace_.pop_front();
+std::vector<std::uint32_t>
+LL1Parser::CellProductions(symbol_id non_terminal, symbol_id terminal) const {
+    size_t          idx{CellIndex(non_terminal, terminal)};
+    const ll1_cell& cell = ll1_t_[idx];
+    if (cell.production == Grammar::kNoProduction) {
+        return {};
     }
-    std::cout << "]\n";
-}
-
-bool LL1Parser::MatchTerminal(const std::string& top_symbol,
-                              const std::string& current_symbol) {
-    trace_.push_back(current_symbol);
-    if (trace_.size() > kTraceSize) {
-        trace_.pop_front();
+    if (!cell.conflict) {
+        return {cell.production};
     }
-
-    return top_symbol == current_symbol;
+    return conflicts_.at(idx);
 }
 
-bool LL1Parser::ProcessNonTerminal(const std::string& top_symbol,
-                                   const std::string& current_symbol) {
-    auto it = ll1_t_.find(top_symbol);
-    if (it != ll1_t_.end()) {
-        auto prod_it = it->second.find(current_symbol);
-        if (prod_it != it->second.end()) {
-            const production& d_symbols = prod_it->second[0];
-            for (auto& d : std::ranges::reverse_view(d_symbols)) {
-                symbol_stack_.push(d);
+void LL1Parser::ComputeSuffixFirstSets() {
+    empty_suffix_first_ = TerminalSet(gr_.st_.NumTerminals());
+    empty_suffix_first_.Insert(symbol_table::kEpsilon);
+    suffix_first_.assign(gr_.rhs_.size(), TerminalSet(gr_.st_.NumTerminals()));
+
+    for (std::uint32_t p = 0; p < gr_.NumProductions(); ++p) {
+        std::span<const symbol_id> rhs = gr_.Rhs(p);
+        for (size_t i = rhs.size(); i-- > 0;) {
+            TerminalSet&       first = suffix_first_[gr_.prod_offsets_[p] + i];
+            const TerminalSet& rest  = SuffixFirst(p, i + 1);
+            symbol_id          symbol = rhs[i];
+            if (symbol == symbol_table::kEpsilon) {
+                first = rest;
+            } else if (gr_.st_.IsTerminal(symbol)) {
+                first.Insert(symbol);
+            } else {
+                first.MergeWithoutEpsilon(
+                    first_sets_[gr_.st_.NonTerminalIndex(symbol)]);
+                if (gr_.IsNullable(symbol)) {
+                    first.Merge(rest);
+                }
             }
-            return true;
         }
     }
-    return gr_.HasEmptyProduction(top_symbol);
 }
 
-bool LL1Parser::Parse() {
-    Lex lex(text_file_);
-    symbol_stack_.push(gr_.axiom_);
-    std::string current_symbol = lex.Next();
-    while (!current_symbol.empty() && !symbol_stack_.empty()) {
-        if (symbol_stack_.top() == symbol_table::EPSILON_) {
-            symbol_stack_.pop();
-            continue;
-        }
-        const std::string& top_symbol = symbol_stack_.top();
-        symbol_stack_.pop();
-        if (symbol_table::IsTerminal(top_symbol)) {
-            if (!MatchTerminal(top_symbol, current_symbol))
-                return false;
-            current_symbol = lex.Next();
-
-        } else {
-            if (!ProcessNonTerminal(top_symbol, current_symbol))
-                return false;
-        }
-    }
-    return true;
+const TerminalSet& LL1Parser::SuffixFirst(std::uint32_t p, size_t i) const {
+    size_t k{gr_.prod_offsets_[p] + i};
+    return k < gr_.prod_offsets_[p + 1] ? suffix_first_[k]
+                                        : empty_suffix_first_;
 }
 
-void LL1Parser::First(std::span<const std::string>     rule,
-                      std::unordered_set<std::string>& result) {
-    if (rule.empty() ||
-        (rule.size() == 1 && rule[0] == symbol_table::EPSILON_)) {
-        result.insert(symbol_table::EPSILON_);
-        return;
+void LL1Parser::ComputeFirstSets() {
+    // Initialize FIRST sets for each non-terminal, with ε if it is nullable
+    first_sets_.assign(gr_.st_.NumNonTerminals(),
+                       TerminalSet(gr_.st_.NumTerminals()));
+    for (symbol_id nt = gr_.st_.NumTerminals(); nt < gr_.st_.Size(); ++nt) {
+        if (gr_.IsNullable(nt)) {
+            first_sets_[gr_.st_.NonTerminalIndex(nt)].Insert(
+                symbol_table::kEpsilon);
+        }
     }
 
-    bool allEpsilon = true;
-
-    if (symbol_table::IsTerminal(rule[0])) {
-        result.insert(rule[0]);
-        return;
+    // Seed the sets with the terminals that start each production and
+    // record which non-terminals each FIRST set flows into
+    std::vector<std::vector<symbol_id>> dependents(gr_.st_.NumNonTerminals());
+    for (std::uint32_t p = 0; p < gr_.NumProductions(); ++p) {
+        symbol_id lhs = gr_.Lhs(p);
+        for (symbol_id symbol : gr_.Rhs(p)) {
+            if (symbol == symbol_table::kEpsilon) {
+                continue;
+            }
+            // EOL never starts a non-terminal: reaching it makes the
+            // non-terminal nullable instead, see Grammar::ComputeNullable
+            if (symbol == symbol_table::kEol) {
+                break;
+            }
+            if (gr_.st_.IsTerminal(symbol)) {
+                first_sets_[gr_.st_.NonTerminalIndex(lhs)].Insert(symbol);
+                break;
+            }
+            if (symbol != lhs) {
+                dependents[gr_.st_.NonTerminalIndex(symbol)].push_back(lhs);
+            }
+            if (!gr_.IsNullable(symbol)) {
+                break;
+            }
+        }
     }
 
-    const std::unordered_set<std::string>& fii = first_sets_[rule[0]];
-    for (const auto& s : fii) {
-        if (s != symbol_table::EPSILON_) {
-            result.insert(s);
-        }
+    std::vector<symbol_id> worklist;
+    std::vector<bool>      queued(gr_.st_.NumNonTerminals(), true);
+    for (symbol_id nt = gr_.st_.NumTerminals(); nt < gr_.st_.Size(); ++nt) {
+        worklist.push_back(nt);
     }
-    if (fii.find(symbol_table::EPSILON_) == fii.cend()) {
-        return;
+    while (!worklist.empty()) {
+        symbol_id nt = worklist.back();
+        worklist.pop_back();
+        queued[gr_.st_.NonTerminalIndex(nt)] = false;
+
+        const TerminalSet& first = first_sets_[gr_.st_.NonTerminalIndex(nt)];
+        for (symbol_id dependent : dependents[gr_.st_.NonTerminalIndex(nt)]) {
+            symbol_id i{gr_.st_.NonTerminalIndex(dependent)};
+            if (first_sets_[i].MergeWithoutEpsilon(first) && !queued[i]) {
+                queued[i] = true;
+                worklist.push_back(dependent);
+            }
+        }
     }
-    First(std::span<const std::string>(rule.begin() + 1, rule.end()), result);
 }
 
-void LL1Parser::ComputeFirstSets() {
-    // Initialize FIRST sets for each non-terminal
-    for (const auto& [nonTerminal, _] : gr_.g_) {
-        first_sets_[nonTerminal] = {};
+void LL1Parser::ComputeFollowSets() {
+    size_t n{gr_.st_.NumNonTerminals()};
+    follow_sets_.assign(n, TerminalSet(gr_.st_.NumTerminals()));
+    follow_sets_[gr_.st_.NonTerminalIndex(gr_.axiom_)].Insert(
+        symbol_table::kEol);
+
+    // Direct contributions, and includes[B] = { A | FOLLOW(B) ⊇ FOLLOW(A) }
+    std::vector<std::vector<std::uint32_t>> includes(n);
+    for (std::uint32_t p = 0; p < gr_.NumProductions(); ++p) {
+        symbol_id                  lhs = gr_.Lhs(p);
+        std::span<const symbol_id> rhs = gr_.Rhs(p);
+        for (size_t i = 0; i < rhs.size(); ++i) {
+            symbol_id symbol = rhs[i];
+            if (!gr_.st_.IsTerminal(symbol) && UpdateFollow(symbol, p, i) &&
+                symbol != lhs) {
+                includes[gr_.st_.NonTerminalIndex(symbol)].push_back(
+                    gr_.st_.NonTerminalIndex(lhs));
+            }
+        }
     }
 
-    bool changed;
-    do {
-        auto old_first_sets = first_sets_; // Copy current state
-
-        for (const auto& [nonTerminal, productions] : gr_.g_) {
-            for (const auto& prod : productions) {
-                std::unordered_set<std::string> tempFirst;
-                First(prod, tempFirst);
-
-                if (tempFirst.contains(symbol_table::EOL_)) {
-                    tempFirst.erase(symbol_table::EOL_);
-                    tempFirst.insert(symbol_table::EPSILON_);
+    // DeRemer and Pennello's Digraph traversal, with an explicit call stack.
+    // depth[x] is 0 while x is unvisited and kDone once its set is final.
+    struct frame {
+        std::uint32_t node;
+        std::uint32_t depth;
+        std::uint32_t next_edge;
+    };
+    constexpr std::uint32_t kDone{std::numeric_limits<std::uint32_t>::max()};
+    std::vector<std::uint32_t> depth(n, 0);
+    std::vector<std::uint32_t> component;
+    std::vector<frame>         frames;
+
+    auto visit = [&](std::uint32_t x) {
+        component.push_back(x);
+        depth[x] = static_cast<std::uint32_t>(component.size());
+        frames.push_back({x, depth[x], 0});
+    };
+
+    for (std::uint32_t root = 0; root < n; ++root) {
+        if (depth[root] != 0) {
+            continue;
+        }
+        visit(root);
+        while (!frames.empty()) {
+            frame& f = frames.back();
+            if (f.next_edge < includes[f.node].size()) {
+                std::uint32_t x = f.node;
+                std::uint32_t y = includes[x][f.next_edge++];
+                if (depth[y] == 0) {
+                    visit(y);
+                    continue;
                 }
-                // Insert the computed FIRST into the non-terminal's set
-                auto& current_set = first_sets_[nonTerminal];
-                current_set.insert(tempFirst.begin(), tempFirst.end());
+                depth[x] = std::min(depth[x], depth[y]);
+                follow_sets_[x].Merge(follow_sets_[y]);
+                continue;
             }
-        }
-
-        // Check if any changes occurred
-        changed = (old_first_sets != first_sets_);
-
-    } while (changed);
-}
 
-void LL1Parser::ComputeFollowSets() {
-    for (const auto& [nt, _] : gr_.g_) {
-        follow_sets_[nt] = {};
-    }
-    follow_sets_[gr_.axiom_].insert(symbol_table::EOL_);
-
-    bool changed;
-    do {
-        changed = false;
-        for (const auto& rule : gr_.g_) {
-            const std::string& lhs = rule.first;
-            for (const production& rhs : rule.second) {
-                for (size_t i = 0; i < rhs.size(); ++i) {
-                    const std::string& symbol = rhs[i];
-                    if (!symbol_table::IsTerminal(symbol)) {
-                        changed |= UpdateFollow(symbol, lhs, rhs, i);
+            frame done = f;
+            frames.pop_back();
+            std::uint32_t x = done.node;
+            if (depth[x] == done.depth) {
+                // x is the root of a strongly connected component, whose
+                // members all share its FOLLOW set
+                std::uint32_t top;
+                do {
+                    top = component.back();
+                    component.pop_back();
+                    depth[top] = kDone;
+                    if (top != x) {
+                        follow_sets_[top] = follow_sets_[x];
                     }
-                }
+                } while (top != x);
+            }
+            if (!frames.empty()) {
+                std::uint32_t parent = frames.back().node;
+                depth[parent]        = std::min(depth[parent], depth[x]);
+                follow_sets_[parent].Merge(follow_sets_[x]);
             }
         }
-    } while (changed);
+    }
 }
 
-bool LL1Parser::UpdateFollow(const std::string& symbol, const std::string& lhs,
-                             const production& rhs, size_t i) {
-    bool changed = false;
-
-    std::unordered_set<std::string> first_remaining;
-    if (i + 1 < rhs.size()) {
-        First(std::span<const std::string>(rhs.begin() + i + 1, rhs.end()),
-              first_remaining);
-    } else {
-        first_remaining.insert(symbol_table::EPSILON_);
-    }
+bool LL1Parser::UpdateFollow(symbol_id symbol, std::uint32_t p, size_t i) {
+    const TerminalSet& first_remaining = SuffixFirst(p, i + 1);
 
     // Add FIRST(β) \ {ε}
-    for (const auto& terminal : first_remaining) {
-        if (terminal != symbol_table::EPSILON_) {
-            changed |= follow_sets_[symbol].insert(terminal).second;
-        }
-    }
-
-    // If FIRST(β) contains ε, add FOLLOW(lhs)
-    if (first_remaining.contains(symbol_table::EPSILON_)) {
-        for (const auto& terminal : follow_sets_[lhs]) {
-            changed |= follow_sets_[symbol].insert(terminal).second;
-        }
-    }
+    follow_sets_[gr_.st_.NonTerminalIndex(symbol)].MergeWithoutEpsilon(
+        first_remaining);
 
-    return changed;
+    return first_remaining.Contains(symbol_table::kEpsilon);
 }
 
-std::unordered_set<std::string> LL1Parser::Follow(const std::string& arg) {
-    auto it = follow_sets_.find(arg);
-    if (it != follow_sets_.end()) {
-        return it->second;
-    }
-    return {};
+const TerminalSet& LL1Parser::Follow(symbol_id arg) const {
+    return follow_sets_[gr_.st_.NonTerminalIndex(arg)];
 }
 
-std::unordered_set<std::string>
-LL1Parser::PredictionSymbols(const std::string&              antecedent,
-                             const std::vector<std::string>& consequent) {
-    std::unordered_set<std::string> hd{};
-    First({consequent}, hd);
-    if (!hd.contains(symbol_table::EPSILON_)) {
+TerminalSet LL1Parser::PredictionSymbols(std::uint32_t p) const {
+    TerminalSet hd{SuffixFirst(p, 0)};
+    if (!hd.Contains(symbol_table::kEpsilon)) {
         return hd;
     }
-    hd.erase(symbol_table::EPSILON_);
-    hd.merge(Follow(antecedent));
+    hd.Erase(symbol_table::kEpsilon);
+    hd.Merge(Follow(gr_.Lhs(p)));
     return hd;
 }
 
-void LL1Parser::PrintTable() {
+void LL1Parser::PrintTable() const {
     if (print_table_format_) {
         PrintTableUsingTabulate();
         return;
     }
-    for (const auto& outerPair : ll1_t_) {
-        const std::string& nonTerminal = outerPair.first;
-        std::cout << "Non-terminal: " << nonTerminal << "\n";
-
-        for (const auto& innerPair : outerPair.second) {
-            const std::string& symbol      = innerPair.first;
-            const auto&        productions = innerPair.second;
+    for (symbol_id nonTerminal = gr_.st_.NumTerminals();
+         nonTerminal < gr_.st_.Size(); ++nonTerminal) {
+        std::cout << "Non-terminal: " << gr_.st_.Name(nonTerminal)
+                  << "\n";
+
+        for (symbol_id symbol = 0; symbol < gr_.st_.NumTerminals();
+             ++symbol) {
+            const auto productions = CellProductions(nonTerminal, symbol);
+            if (productions.empty()) {
+                continue;
+            }
 
-            std::cout << "\tSymbol: " << symbol << " -> { ";
-            for (const auto& prod : productions) {
+            std::cout << "\tSymbol: " << gr_.st_.Name(symbol) << " -> { ";
+            for (std::uint32_t prod : productions) {
                 std::cout << "[ ";
-                for (const std::string& elem : prod) {
-                    std::cout << elem << " ";
+                for (symbol_id elem : gr_.Rhs(prod)) {
+                    std::cout << gr_.st_.Name(elem) << " ";
                 }
                 std::cout << "] ";
             }
@@ -298,21 +367,26 @@ void LL1Parser::PrintTable() {
     }
 }
 
-void LL1Parser::PrintTableUsingTabulate() {
+void LL1Parser::PrintTableUsingTabulate() const {
     using namespace tabulate;
     Table table;
 
-    Table::Row_t                          headers = {"Non-terminal"};
-    std::unordered_map<std::string, bool> columns;
+    Table::Row_t           headers = {"Non-terminal"};
+    std::vector<symbol_id> columns;
 
-    for (const auto& outerPair : ll1_t_) {
-        for (const auto& innerPair : outerPair.second) {
-            columns[innerPair.first] = true;
+    for (symbol_id col = 0; col < gr_.st_.NumTerminals(); ++col) {
+        for (symbol_id nt = gr_.st_.NumTerminals();
+             nt < gr_.st_.Size(); ++nt) {
+            if (ll1_t_[CellIndex(nt, col)].production !=
+                Grammar::kNoProduction) {
+                columns.push_back(col);
+                break;
+            }
         }
     }
 
-    for (const auto& col : columns) {
-        headers.push_back(col.first);
+    for (symbol_id col : columns) {
+        headers.push_back(gr_.st_.Name(col));
     }
 
     auto& header_row = table.add_row(headers);
@@ -321,28 +395,29 @@ void LL1Parser::PrintTableUsingTabulate() {
         .font_color(Color::yellow)
         .font_style({FontStyle::bold});
 
-    std::vector<std::string> non_terminals;
-    for (const auto& outerPair : ll1_t_) {
-        non_terminals.push_back(outerPair.first);
+    std::vector<symbol_id> non_terminals;
+    for (symbol_id nt = gr_.st_.NumTerminals(); nt < gr_.st_.Size();
+         ++nt) {
+        non_terminals.push_back(nt);
     }
 
-    std::ranges::sort(non_terminals, [this](const std::string& a, const std::string& b) {
+    std::ranges::sort(non_terminals, [this](symbol_id a, symbol_id b) {
         return (a == gr_.axiom_) ? true 
             : (b == gr_.axiom_) ? false
-            : a < b;
+            : gr_.st_.Name(a) < gr_.st_.Name(b);
     });
 
-    for (const std::string& nonTerminal : non_terminals) {
-        Table::Row_t row_data = {nonTerminal};
+    for (symbol_id nonTerminal : non_terminals) {
+        Table::Row_t row_data = {gr_.st_.Name(nonTerminal)};
 
-        for (const auto& col : columns) {
-            auto innerIt = ll1_t_.at(nonTerminal).find(col.first);
-            if (innerIt != ll1_t_.at(nonTerminal).end()) {
+        for (symbol_id col : columns) {
+            const auto productions = CellProductions(nonTerminal, col);
+            if (!productions.empty()) {
                 std::string cell_content;
-                for (const auto& prod : innerIt->second) {
+                for (std::uint32_t prod : productions) {
                     cell_content += "[ ";
-                    for (const std::string& elem : prod) {
-                        cell_content += elem + " ";
+                    for (symbol_id elem : gr_.Rhs(prod)) {
+                        cell_content += gr_.st_.Name(elem) + " ";
                     }
                     cell_content += "] ";
                 }
@@ -1,10 +1,19 @@
 #include <boost/program_options.hpp>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <ostream>
 #include <string>
+#include <system_error>
+#include <vector>
 
+#include "../include/cpp_emitter.hpp"
 #include "../include/ll1_parser.hpp"
+#include "../include/parse_session.hpp"
+#include "../include/parse_tree.hpp"
+#include "../include/work_stealing_pool.hpp"
 namespace po = boost::program_options;
 
 int PrintFileToStdout(const std::string& filename) {
@@ -19,16 +28,94 @@ int PrintFileToStdout(const std::string& filename) {
     return 0;
 }
 
+std::vector<std::string> ReadFileList(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        throw std::runtime_error("Batch list file not found");
+    }
+    std::vector<std::string> files;
+    std::string              line;
+    while (getline(file, line)) {
+        if (!line.empty()) {
+            files.push_back(line);
+        }
+    }
+    return files;
+}
+
+int RunBatch(const LL1Parser& parser, const std::vector<std::string>& files,
+             unsigned jobs, bool all_errors) {
+    WorkStealingPool         pool(jobs);
+    std::deque<ParseSession> sessions;
+    for (unsigned w = 0; w < pool.NumThreads(); ++w) {
+        sessions.emplace_back(parser, 0);
+        sessions.back().SetRecovery(all_errors);
+    }
+
+    std::vector<char>        accepted(files.size());
+    std::vector<std::size_t> syntax_errors(files.size());
+    std::vector<std::string> errors(files.size());
+    pool.Run(files.size(), [&](unsigned worker, std::size_t i) {
+        std::error_code ec;
+        auto            size = std::filesystem::file_size(files[i], ec);
+        if (ec) {
+            errors[i] = "Text file not found";
+        } else if (size == 0) {
+            errors[i] = "Text file is empty";
+        } else {
+            try {
+                accepted[i]      = sessions[worker].ParseFile(files[i]);
+                syntax_errors[i] = sessions[worker].Errors().size();
+            } catch (const std::exception& e) {
+                errors[i] = e.what();
+            }
+        }
+    });
+
+    std::size_t num_accepted{0}, num_rejected{0}, num_errors{0};
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        std::cout << files[i] << ": ";
+        if (!errors[i].empty()) {
+            std::cout << "error: " << errors[i] << "\n";
+            ++num_errors;
+        } else if (accepted[i]) {
+            std::cout << "accepted\n";
+            ++num_accepted;
+        } else {
+            std::cout << "rejected";
+            if (all_errors)
+                std::cout << ", " << syntax_errors[i] << " syntax error"
+                          << (syntax_errors[i] == 1 ? "" : "s");
+            std::cout << "\n";
+            ++num_rejected;
+        }
+    }
+    std::cout << files.size() << (files.size() == 1 ? " file: " : " files: ")
+              << num_accepted << " accepted, " << num_rejected << " rejected, "
+              << num_errors << (num_errors == 1 ? " error\n" : " errors\n");
+    return num_accepted == files.size() ? 0 : 1;
+}
+
 void ShowUsage(const char* program_name, const po::options_description& desc) {
     std::cout << "Usage: " << program_name
               << " <grammar_filename> [<text_filename>] [options]\n"
+              << "       " << program_name
+              << " <grammar_filename> --batch <text_filename>... [options]\n"
               << desc;
 }
 
 int main(int argc, char* argv[]) {
     std::string grammar_filename, text_filename;
     bool        verbose_mode = false;
+    bool        print_tree   = false;
+    bool        all_errors   = false;
+    std::string emit_cpp;
+    std::string emit_header;
     std::string table_format = "new";
+    std::size_t history_size = ParseSession::kDefaultHistorySize;
+    std::vector<std::string> batch_files;
+    std::string              batch_list;
+    unsigned                 jobs = 0;
 
     po::options_description desc("Options");
     desc.add_options()("help,h", "Show help message")(
@@ -36,6 +123,23 @@ int main(int argc, char* argv[]) {
         "Enable verbose mode with new table format")(
         "format", po::value<std::string>(),
         "Set table format (old/new), implies verbose mode")(
+        "history", po::value<std::size_t>(&history_size),
+        "Number of processed symbols shown when parsing fails (0 disables "
+        "it)")("batch",
+               po::value<std::vector<std::string>>(&batch_files)->multitoken(),
+               "Validate several text files in parallel")(
+        "batch-list", po::value<std::string>(&batch_list),
+        "File listing the text files to validate, one per line, as --batch")(
+        "jobs,j", po::value<unsigned>(&jobs),
+        "Number of threads for --batch (default: one per hardware thread)")(
+        "tree", po::bool_switch(&print_tree),
+        "Print the parse tree of the input if it is accepted")(
+        "all-errors", po::bool_switch(&all_errors),
+        "Recover from syntax errors and report all of them")(
+        "emit-cpp", po::value<std::string>(&emit_cpp),
+        "Write a self-contained C++ parser for the grammar to a file")(
+        "emit-header", po::value<std::string>(&emit_header),
+        "Write the tables of the grammar as a constexpr C++ header")(
         "grammar", po::value<std::string>(&grammar_filename)->required(),
         "Grammar file")("text", po::value<std::string>(&text_filename),
                         "Text file to parse");
@@ -69,6 +173,20 @@ int main(int argc, char* argv[]) {
             if (table_format.empty())
                 table_format = "new";
         }
+        if ((vm.contains("batch") || vm.contains("batch-list")) &&
+            !text_filename.empty()) {
+            throw std::runtime_error(
+                "A text file cannot be combined with --batch");
+        }
+        if ((vm.contains("batch") || vm.contains("batch-list")) &&
+            (print_tree || vm.contains("history"))) {
+            throw std::runtime_error(
+                "--tree and --history cannot be combined with --batch");
+        }
+        if (all_errors && print_tree) {
+            throw std::runtime_error(
+                "--all-errors cannot be combined with --tree");
+        }
 
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n\n";
@@ -82,8 +200,7 @@ int main(int argc, char* argv[]) {
     }
 
     try {
-        LL1Parser parser{grammar_filename, text_filename,
-                         table_format == "new"};
+        LL1Parser parser{grammar_filename, table_format == "new"};
         std::cout << "Grammar is LL(1)\n";
 
         if (verbose_mode) {
@@ -101,6 +218,32 @@ int main(int argc, char* argv[]) {
             std::cout << "--------------------------------\n\n";
         }
 
+        if (!emit_cpp.empty()) {
+            std::ofstream out(emit_cpp);
+            if (!out)
+                throw std::runtime_error("Cannot write " + emit_cpp);
+            std::string name = std::filesystem::path(emit_cpp).stem().string();
+            CppEmitter(parser, name).Emit(out);
+            std::cout << "C++ parser written to " << emit_cpp << "\n";
+        }
+        if (!emit_header.empty()) {
+            std::ofstream out(emit_header);
+            if (!out)
+                throw std::runtime_error("Cannot write " + emit_header);
+            std::string name =
+                std::filesystem::path(emit_header).stem().string();
+            CppEmitter(parser, name).EmitHeader(out);
+            std::cout << "C++ header written to " << emit_header << "\n";
+        }
+
+        if (!batch_list.empty()) {
+            std::vector<std::string> listed = ReadFileList(batch_list);
+            batch_files.insert(batch_files.end(), listed.begin(), listed.end());
+        }
+        if (!batch_files.empty()) {
+            return RunBatch(parser, batch_files, jobs, all_errors);
+        }
+
         if (!text_filename.empty()) {
             std::ifstream file(text_filename);
             if (!file)
@@ -108,14 +251,29 @@ int main(int argc, char* argv[]) {
             if (file.peek() == EOF)
                 throw std::runtime_error("Text file is empty");
 
-            if (parser.Parse()) {
+            ParseSession session{parser, history_size};
+            session.SetRecovery(all_errors);
+            ParseTree    tree;
+            bool         accepted = print_tree
+                                        ? session.ParseFile(text_filename, tree)
+                                        : session.ParseFile(text_filename);
+            if (accepted) {
                 std::cout << "Parsing successful\n";
+                if (print_tree)
+                    tree.Print(parser.GetGrammar().st_, std::cout);
                 if (verbose_mode)
-                    parser.PrintStackTrace();
+                    session.PrintStackTrace();
             } else {
                 std::cerr << "Parsing failed\n";
-                parser.PrintStackTrace();
-                parser.PrintSymbolHist();
+                if (all_errors) {
+                    session.PrintErrors(std::cerr);
+                    std::size_t count = session.Errors().size();
+                    std::cerr << count << " syntax error"
+                              << (count == 1 ? "\n" : "s\n");
+                    return 1;
+                }
+                session.PrintStackTrace();
+                session.PrintSymbolHist();
                 return 1;
             }
         }
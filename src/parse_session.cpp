@@ -0,0 +1,226 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "../include/grammar.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/parse_session.hpp"
+#include "../include/parse_tree.hpp"
+#include "../include/symbol_history.hpp"
+#include "../include/symbol_table.hpp"
+
+ParseSession::ParseSession(const LL1Parser& parser, std::size_t history_size)
+    : parser_(parser), gr_(parser.GetGrammar()), trace_(history_size),
+      lex_(gr_.st_) {}
+
+void ParseSession::PrintStackTrace() {
+    std::cout << "Parser stack trace : [ ";
+    while (!symbol_stack_.empty()) {
+        if ((symbol_stack_.back() & kCloseBit) == 0) {
+            std::cout << gr_.st_.Name(symbol_stack_.back()) << " ";
+        }
+        symbol_stack_.pop_back();
+    }
+    std::cout << "]\n";
+}
+
+void ParseSession::PrintSymbolHist() {
+    if (trace_.Capacity() == 0) {
+        return;
+    }
+    std::cout << "Last " << trace_.Capacity() << " processed symbols : [ ";
+    trace_.ForEach(
+        [this](symbol_id symbol) { std::cout << gr_.st_.Name(symbol) << " "; });
+    trace_.Clear();
+    std::cout << "]\n";
+}
+
+void ParseSession::SetHistorySize(std::size_t size) {
+    trace_ = SymbolHistory(size);
+}
+
+bool ParseSession::ProcessNonTerminal(symbol_id top_symbol,
+                                      symbol_id current_symbol) {
+    std::uint32_t production = parser_.Prediction(top_symbol, current_symbol);
+    if (production != Grammar::kNoProduction) {
+        std::span<const symbol_id> d_symbols = parser_.PushSequence(production);
+        symbol_stack_.insert(symbol_stack_.end(), d_symbols.begin(),
+                             d_symbols.end());
+        return true;
+    }
+    return gr_.HasEmptyProduction(top_symbol);
+}
+
+bool ParseSession::ParseFile(const std::string& filename) {
+    lex_.Open(filename);
+    return ParseLexed();
+}
+
+bool ParseSession::ParseText(std::string_view text) {
+    lex_.Reset(text);
+    return ParseLexed();
+}
+
+bool ParseSession::ParseFile(const std::string& filename, ParseTree& tree) {
+    TreeBuilder builder(parser_, tree);
+    if (!ParseFile(filename, builder)) {
+        tree.Discard();
+        return false;
+    }
+    return true;
+}
+
+bool ParseSession::ParseText(std::string_view text, ParseTree& tree) {
+    TreeBuilder builder(parser_, tree);
+    if (!ParseText(text, builder)) {
+        tree.Discard();
+        return false;
+    }
+    return true;
+}
+
+bool ParseSession::ParseLexed() {
+    StartParse();
+    lex_.TrackRanges(recover_);
+
+    parse_status status{RUNNING};
+    for (auto chunk = lex_.NextChunk(); status == RUNNING && !chunk.empty();
+         chunk      = lex_.NextChunk()) {
+        status = recover_ ? FeedRecovering(chunk, lex_.Ranges()) : Feed(chunk);
+    }
+    return recover_ ? errors_.empty() : status != REJECTED;
+}
+
+bool ParseSession::Parse(std::span<const symbol_id> tokens) {
+    StartParse();
+    return Feed(tokens) != REJECTED;
+}
+
+void ParseSession::StartParse() {
+    symbol_stack_.reserve(kInitialStackSize);
+    symbol_stack_.clear();
+    symbol_stack_.push_back(gr_.axiom_);
+    trace_.Clear();
+    errors_.clear();
+    recovering_ = false;
+}
+
+ParseSession::parse_status
+ParseSession::Feed(std::span<const symbol_id> tokens) {
+    symbol_id    num_terminals{gr_.st_.NumTerminals()};
+    size_t       pos{0};
+    parse_status status{RUNNING};
+    while (pos < tokens.size()) {
+        if (symbol_stack_.empty()) {
+            status = ACCEPTED;
+            break;
+        }
+        symbol_id top_symbol = symbol_stack_.back();
+        symbol_stack_.pop_back();
+        if (top_symbol < num_terminals) {
+            // The mismatched token counts as processed in the history
+            if (top_symbol != tokens[pos++]) {
+                status = REJECTED;
+                break;
+            }
+        } else if (!ProcessNonTerminal(top_symbol, tokens[pos])) {
+            status = REJECTED;
+            break;
+        }
+    }
+    trace_.Record(tokens.first(pos));
+    return status;
+}
+
+ParseSession::parse_status
+ParseSession::FeedRecovering(std::span<const symbol_id>   tokens,
+                             std::span<const token_range> ranges) {
+    symbol_id    num_terminals{gr_.st_.NumTerminals()};
+    size_t       pos{0};
+    parse_status status{RUNNING};
+    while (pos < tokens.size()) {
+        if (symbol_stack_.empty()) {
+            status = ACCEPTED;
+            break;
+        }
+        symbol_id token      = tokens[pos];
+        symbol_id top_symbol = symbol_stack_.back();
+        if (top_symbol == token) {
+            symbol_stack_.pop_back();
+            recovering_ = false;
+            ++pos;
+            continue;
+        }
+
+        if (top_symbol < num_terminals) {
+            ReportError(ranges[pos].begin, token, top_symbol);
+            if (token == symbol_table::kEol || MatchesBelowTop(token)) {
+                // The terminal is missing
+                symbol_stack_.pop_back();
+            } else {
+                // The token is unexpected
+                ++pos;
+            }
+            continue;
+        }
+
+        symbol_stack_.pop_back();
+        if (ProcessNonTerminal(top_symbol, token)) {
+            continue;
+        }
+        ReportError(ranges[pos].begin, token, top_symbol);
+        if (token != symbol_table::kEol &&
+            !parser_.Follow(top_symbol).Contains(token)) {
+            // Skip the token, the non-terminal may start after it
+            symbol_stack_.push_back(top_symbol);
+            ++pos;
+        }
+    }
+    trace_.Record(tokens.first(pos));
+    return status;
+}
+
+bool ParseSession::MatchesBelowTop(symbol_id token) const {
+    if (symbol_stack_.size() < 2) {
+        return false;
+    }
+    symbol_id below = symbol_stack_[symbol_stack_.size() - 2];
+    if (gr_.st_.IsTerminal(below)) {
+        return below == token;
+    }
+    return parser_.Prediction(below, token) != Grammar::kNoProduction ||
+           (gr_.HasEmptyProduction(below) &&
+            parser_.Follow(below).Contains(token));
+}
+
+void ParseSession::ReportError(std::size_t offset, symbol_id found,
+                               symbol_id expected) {
+    if (!recovering_) {
+        errors_.push_back({offset, found, expected});
+        recovering_ = true;
+    }
+}
+
+void ParseSession::PrintErrors(std::ostream& out) const {
+    for (const syntax_error& error : errors_) {
+        out << "Syntax error at byte " << error.offset << ": unexpected "
+            << gr_.st_.Name(error.found) << ", expected ";
+        if (gr_.st_.IsTerminal(error.expected)) {
+            out << gr_.st_.Name(error.expected);
+        } else {
+            out << "one of [ ";
+            for (symbol_id t = 0; t < gr_.st_.NumTerminals(); ++t) {
+                if (parser_.Prediction(error.expected, t) !=
+                    Grammar::kNoProduction) {
+                    out << gr_.st_.Name(t) << " ";
+                }
+            }
+            out << "]";
+        }
+        out << "\n";
+    }
+}
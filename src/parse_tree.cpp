@@ -0,0 +1,48 @@
+#include "../include/parse_tree.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+void ParseTree::Print(const symbol_table& st, std::ostream& out) const {
+    if (root_ == nullptr) {
+        return;
+    }
+    // Depth-first with an explicit stack, trees can be very deep
+    std::vector<std::pair<const parse_node*, std::size_t>> pending{{root_, 0}};
+    while (!pending.empty()) {
+        auto [node, depth] = pending.back();
+        pending.pop_back();
+        out << std::string(2 * depth, ' ') << st.Name(node->symbol) << " ["
+            << node->begin << ", " << node->end << ")\n";
+        for (const parse_node& child :
+             std::ranges::reverse_view(node->Children())) {
+            pending.emplace_back(&child, depth + 1);
+        }
+    }
+}
+
+TreeBuilder::TreeBuilder(const LL1Parser& parser, ParseTree& tree)
+    : parser_(parser), tree_(tree) {
+    tree_.Clear();
+}
+
+void TreeBuilder::ExitNonTerminal(symbol_id /*non_terminal*/,
+                                  std::size_t end) {
+    auto [node, filled] = open_.back();
+    open_.pop_back();
+    node->end = end;
+    // The push sequence is reversed, its first symbol is the last child
+    std::span<const symbol_id> d_symbols =
+        parser_.PushSequence(node->production);
+    for (std::uint32_t i = filled; i < node->num_children; ++i) {
+        parse_node& child = node->children[i];
+        child.symbol      = d_symbols[node->num_children - 1 - i];
+        child.begin       = end;
+        child.end         = end;
+    }
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../include/grammar.hpp"
+#include "../include/lexer.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/parse_events.hpp"
+#include "../include/push_session.hpp"
+#include "../include/symbol_table.hpp"
+
+const parse_event* PushSession::parse_task::Next() {
+    if (handle_.done()) {
+        return nullptr;
+    }
+    handle_.resume();
+    promise_type& promise = handle_.promise();
+    if (promise.error) {
+        std::rethrow_exception(std::exchange(promise.error, {}));
+    }
+    return promise.event;
+}
+
+PushSession::PushSession(const LL1Parser& parser)
+    : parser_(parser), gr_(parser.GetGrammar()), lex_(gr_.st_),
+      task_(Run()) {
+    lex_.TrackRanges(true);
+}
+
+PushSession::event_range PushSession::Push(std::string_view bytes) {
+    if (!task_.Done()) {
+        input_.append(bytes);
+    }
+    return event_range(&task_);
+}
+
+PushSession::event_range PushSession::Finish() {
+    finished_ = true;
+    return event_range(&task_);
+}
+
+void PushSession::LexInput(std::vector<symbol_id>&   tokens,
+                           std::vector<token_range>& ranges) {
+    // Without new bytes, the held-back token would be scanned for nothing
+    if (input_.size() == held_ && !finished_) {
+        return;
+    }
+    std::size_t size{0};
+    std::span<const symbol_id> chunk = lex_.Feed(input_, finished_, size);
+    tokens.insert(tokens.end(), chunk.begin(), chunk.end());
+    ranges.insert(ranges.end(), lex_.Ranges().begin(), lex_.Ranges().end());
+    input_.erase(0, size);
+    held_ = input_.size();
+}
+
+PushSession::parse_task PushSession::Run() {
+    symbol_id                num_terminals{gr_.st_.NumTerminals()};
+    std::vector<symbol_id>   symbol_stack{gr_.axiom_};
+    std::vector<std::size_t> open_begins;
+    std::size_t              last_end{0};
+    std::vector<symbol_id>   tokens;
+    std::vector<token_range> ranges;
+    std::size_t              pos{0};
+
+    // Pops the innermost open non-terminal, see ParseSession::CloseOffset
+    auto exit_event = [&](symbol_id entry) {
+        std::size_t end = std::max(open_begins.back(), last_end);
+        open_begins.pop_back();
+        return parse_event{parse_event::EXIT, entry & ~kCloseBit, 0, 0,
+                           {end, end}};
+    };
+
+    for (;;) {
+        while (pos == tokens.size()) {
+            tokens.clear();
+            ranges.clear();
+            pos = 0;
+            try {
+                LexInput(tokens, ranges);
+            } catch (...) {
+                rejected_ = true;
+                throw;
+            }
+            if (!tokens.empty()) {
+                break;
+            }
+            if (finished_) {
+                // The input ended before the stack emptied
+                for (symbol_id entry :
+                     std::ranges::reverse_view(symbol_stack)) {
+                    if ((entry & kCloseBit) != 0) {
+                        co_yield exit_event(entry);
+                    }
+                }
+                co_return;
+            }
+            co_yield parse_task::need_input{};
+        }
+
+        if (symbol_stack.empty()) {
+            co_return;
+        }
+        symbol_id top_symbol = symbol_stack.back();
+        symbol_stack.pop_back();
+        if ((top_symbol & kCloseBit) != 0) {
+            co_yield exit_event(top_symbol);
+            continue;
+        }
+
+        if (top_symbol < num_terminals) {
+            if (top_symbol != tokens[pos]) {
+                rejected_ = true;
+                co_return;
+            }
+            co_yield parse_event{parse_event::SHIFT, top_symbol, 0, 0,
+                                 ranges[pos]};
+            last_end = ranges[pos++].end;
+            continue;
+        }
+
+        std::uint32_t production = parser_.Prediction(top_symbol, tokens[pos]);
+        std::span<const symbol_id> d_symbols;
+        if (production != Grammar::kNoProduction) {
+            d_symbols = parser_.PushSequence(production);
+        } else if (gr_.HasEmptyProduction(top_symbol)) {
+            production = gr_.EmptyProduction(top_symbol);
+        } else {
+            rejected_ = true;
+            co_return;
+        }
+        std::size_t begin = ranges[pos].begin;
+        open_begins.push_back(begin);
+        symbol_stack.push_back(top_symbol | kCloseBit);
+        symbol_stack.insert(symbol_stack.end(), d_symbols.begin(),
+                            d_symbols.end());
+        co_yield parse_event{parse_event::ENTER, top_symbol, production,
+                             d_symbols.size(), {begin, begin}};
+    }
+}
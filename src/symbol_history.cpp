@@ -0,0 +1,18 @@
+#include "../include/symbol_history.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+void SymbolHistory::Record(std::span<const symbol_id> symbols) {
+    if (ring_.empty()) {
+        return;
+    }
+    if (symbols.size() > ring_.size()) {
+        symbols = symbols.last(ring_.size());
+    }
+    for (symbol_id symbol : symbols) {
+        ring_[head_] = symbol;
+        head_        = head_ + 1 == ring_.size() ? 0 : head_ + 1;
+    }
+    size_ = std::min(size_ + symbols.size(), ring_.size());
+}
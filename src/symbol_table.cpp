@@ -1,43 +1,61 @@
 #include "../include/symbol_table.hpp"
 #include <cstdio>
+#include <stdexcept>
 #include <unordered_map>
 #include <vector>
 
-void symbol_table::PutSymbol(const std::string& identifier,
-                             const std::string& regex) {
-    st_[identifier]          = {TERMINAL, regex};
-    token_types_[identifier] = i_;
-    order_.push_back(i_);
-    token_types_r_[i_++] = identifier;
+symbol_id symbol_table::PutSymbol(const std::string& identifier,
+                                  const std::string& regex) {
+    auto it = ids_.find(identifier);
+    if (it != ids_.end() && IsTerminal(it->second)) {
+        regex_[it->second] = regex;
+        return it->second;
+    }
+    if (it != ids_.end() || names_.size() != regex_.size()) {
+        throw std::logic_error("Terminal " + identifier +
+                               " declared after non-terminals");
+    }
+    auto id = static_cast<symbol_id>(names_.size());
+    ids_.emplace(identifier, id);
+    names_.push_back(identifier);
+    regex_.push_back(regex);
+    return id;
 }
 
-void symbol_table::PutSymbol(const std::string& identifier) {
-    st_.insert({identifier, {NO_TERMINAL, ""}});
+symbol_id symbol_table::PutSymbol(const std::string& identifier) {
+    auto [it, inserted] =
+        ids_.emplace(identifier, static_cast<symbol_id>(names_.size()));
+    if (inserted) {
+        names_.push_back(identifier);
+    }
+    return it->second;
 }
 
-std::string symbol_table::GetValue(const std::string& terminal) {
-    return st_.at(terminal).second;
+const std::string& symbol_table::GetValue(symbol_id terminal) const {
+    return regex_.at(terminal);
 }
 
-void symbol_table::Debug() {
-    printf(" %-15s %-15s %-15s\n", "Identifier", "Type", "Regex");
-    for (const auto& entry : st_) {
-        printf(" %-15s %-15u %-15s\n", entry.first.c_str(), entry.second.first,
-               entry.second.second.c_str());
+void symbol_table::Debug() const {
+    printf(" %-15s %-15s %-15s %-15s\n", "Identifier", "ID", "Type", "Regex");
+    for (symbol_id id = 0; id < Size(); ++id) {
+        printf(" %-15s %-15u %-15u %-15s\n", names_[id].c_str(), id,
+               IsTerminal(id) ? TERMINAL : NO_TERMINAL,
+               IsTerminal(id) ? regex_[id].c_str() : "");
     }
 }
 
-bool symbol_table::In(const std::string& s) {
-    return st_.find(s) != st_.cend();
+bool symbol_table::In(const std::string& s) const {
+    return ids_.find(s) != ids_.cend();
 }
 
-bool symbol_table::IsTerminal(const std::string& s) {
-    return st_.at(s).first == TERMINAL;
+symbol_id symbol_table::Id(const std::string& s) const {
+    return ids_.at(s);
 }
 
 void symbol_table::SetEol(const std::string& eol) {
-    EOL_               = eol;
-    st_[EOL_]          = {TERMINAL, EOL_};
-    token_types_[EOL_] = 1;
-    token_types_r_[1]  = EOL_;
+    ids_.erase(EOL_);
+    EOL_         = eol;
+    ids_[EOL_]   = kEol;
+    names_[kEol] = EOL_;
+    regex_[kEol] = EOL_;
 }
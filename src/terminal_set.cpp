@@ -0,0 +1,47 @@
+#include "../include/terminal_set.hpp"
+#include <cstddef>
+#include <cstdint>
+
+bool TerminalSet::Merge(const TerminalSet& other) {
+    std::uint64_t changed{0};
+    for (std::size_t w = 0; w < words_.size(); ++w) {
+        std::uint64_t merged = words_[w] | other.words_[w];
+        changed |= merged ^ words_[w];
+        words_[w] = merged;
+    }
+    return changed != 0;
+}
+
+bool TerminalSet::MergeWithoutEpsilon(const TerminalSet& other) {
+    if (words_.empty()) {
+        return false;
+    }
+    std::uint64_t epsilon = std::uint64_t{1} << symbol_table::kEpsilon;
+    std::uint64_t first   = words_[0] | (other.words_[0] & ~epsilon);
+    std::uint64_t changed = first ^ words_[0];
+    words_[0]             = first;
+    for (std::size_t w = 1; w < words_.size(); ++w) {
+        std::uint64_t merged = words_[w] | other.words_[w];
+        changed |= merged ^ words_[w];
+        words_[w] = merged;
+    }
+    return changed != 0;
+}
+
+bool TerminalSet::Intersects(const TerminalSet& other) const {
+    for (std::size_t w = 0; w < words_.size(); ++w) {
+        if ((words_[w] & other.words_[w]) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TerminalSet::Empty() const {
+    for (std::uint64_t word : words_) {
+        if (word != 0) {
+            return false;
+        }
+    }
+    return true;
+}
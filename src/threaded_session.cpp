@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/grammar.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/symbol_table.hpp"
+#include "../include/threaded_session.hpp"
+
+ThreadedSession::ThreadedSession(const LL1Parser& parser)
+    : parser_(parser), lex_(parser.GetGrammar().st_) {
+    const Grammar& gr = parser_.GetGrammar();
+    symbol_id      num_terminals{gr.st_.NumTerminals()};
+    if (static_cast<std::size_t>(gr.st_.NumNonTerminals()) * num_terminals >
+        kOperandMask) {
+        throw std::length_error("LL(1) table too large to interpret");
+    }
+
+    std::vector<cell> productions;
+    productions.reserve(gr.NumProductions());
+    for (std::uint32_t p = 0; p < gr.NumProductions(); ++p) {
+        auto begin = static_cast<std::uint32_t>(code_.size());
+        for (symbol_id symbol : parser_.PushSequence(p)) {
+            code_.push_back(Compile(symbol));
+        }
+        auto end = static_cast<std::uint32_t>(code_.size());
+        productions.push_back({begin, end});
+        max_push_ = std::max<std::size_t>(max_push_, end - begin);
+    }
+    auto reject_at = static_cast<std::uint32_t>(code_.size());
+    code_.push_back(Encode(REJECT, 0));
+
+    cells_.resize(static_cast<std::size_t>(gr.st_.NumNonTerminals()) *
+                  num_terminals);
+    cell* row = cells_.data();
+    for (symbol_id nt = num_terminals; nt < gr.st_.Size(); ++nt) {
+        // A miss pops a non-terminal with an empty production, nothing else
+        cell miss = gr.HasEmptyProduction(nt) ? cell{0, 0}
+                                              : cell{reject_at, reject_at + 1};
+        for (symbol_id t = 0; t < num_terminals; ++t) {
+            std::uint32_t production = parser_.Prediction(nt, t);
+            row[t]                   = production == Grammar::kNoProduction
+                                           ? miss
+                                           : productions[production];
+        }
+        row += num_terminals;
+    }
+}
+
+bool ThreadedSession::ParseFile(const std::string& filename) {
+    lex_.Open(filename);
+    return ParseLexed();
+}
+
+bool ThreadedSession::ParseText(std::string_view text) {
+    lex_.Reset(text);
+    return ParseLexed();
+}
+
+bool ThreadedSession::Parse(std::span<const symbol_id> tokens) {
+    StartParse();
+    return Feed(tokens) != REJECTED;
+}
+
+ThreadedSession::instruction ThreadedSession::Compile(symbol_id symbol) const {
+    symbol_id num_terminals{parser_.GetGrammar().st_.NumTerminals()};
+    if (symbol < num_terminals) {
+        return Encode(MATCH, symbol);
+    }
+    return Encode(PREDICT, (symbol - num_terminals) * num_terminals);
+}
+
+bool ThreadedSession::ParseLexed() {
+    StartParse();
+    parse_status status{RUNNING};
+    for (auto chunk = lex_.NextChunk(); status == RUNNING && !chunk.empty();
+         chunk      = lex_.NextChunk()) {
+        status = Feed(chunk);
+    }
+    return status != REJECTED;
+}
+
+void ThreadedSession::StartParse() {
+    if (stack_.size() < kInitialStackSize + max_push_) {
+        stack_.resize(kInitialStackSize + max_push_);
+    }
+    stack_[0] = Encode(ACCEPT, 0);
+    stack_[1] = Compile(parser_.GetGrammar().axiom_);
+    depth_    = 2;
+}
+
+ThreadedSession::parse_status
+ThreadedSession::Feed(std::span<const symbol_id> tokens) {
+    const symbol_id*   pos   = tokens.data();
+    const symbol_id*   end   = pos + tokens.size();
+    const instruction* code  = code_.data();
+    const cell*        cells = cells_.data();
+    instruction*       stack = stack_.data();
+    std::size_t        depth{depth_};
+    parse_status       status{RUNNING};
+    instruction        top;
+
+    // Every handler ends with its own dispatch of the next instruction
+#if LL1_COMPUTED_GOTO
+    static void* const kTargets[] = {&&match, &&predict, &&accept, &&reject};
+#define LL1_DISPATCH()                                                         \
+    do {                                                                       \
+        top = stack[depth - 1];                                                \
+        goto* kTargets[top >> kOperandBits];                                   \
+    } while (0)
+#else
+#define LL1_DISPATCH() goto dispatch
+#endif
+
+    if (pos == end) {
+        return status;
+    }
+    LL1_DISPATCH();
+
+#if !LL1_COMPUTED_GOTO
+dispatch:
+    top = stack[depth - 1];
+    switch (top >> kOperandBits) {
+    case MATCH:
+        goto match;
+    case PREDICT:
+        goto predict;
+    case ACCEPT:
+        goto accept;
+    default:
+        goto reject;
+    }
+#endif
+
+match:
+    --depth;
+    if ((top & kOperandMask) != *pos++) {
+        status = REJECTED;
+        goto done;
+    }
+    if (pos == end) {
+        goto done;
+    }
+    LL1_DISPATCH();
+
+predict: {
+    const cell& next = cells[(top & kOperandMask) + *pos];
+    --depth;
+    if (depth + max_push_ > stack_.size()) {
+        stack_.resize(stack_.size() * 2);
+        stack = stack_.data();
+    }
+    std::copy(code + next.begin, code + next.end, stack + depth);
+    depth += next.end - next.begin;
+    LL1_DISPATCH();
+}
+
+accept:
+    status = ACCEPTED;
+    goto done;
+
+reject:
+    status = REJECTED;
+
+done:
+    depth_ = depth;
+    return status;
+#undef LL1_DISPATCH
+}
@@ -0,0 +1,108 @@
+#include "../include/work_stealing_pool.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+WorkStealingPool::WorkStealingPool(unsigned num_threads)
+    : num_threads_(num_threads != 0
+                       ? num_threads
+                       : std::max(1U, std::thread::hardware_concurrency())),
+      queues_(num_threads_) {
+    threads_.reserve(num_threads_ - 1);
+    for (unsigned w = 1; w < num_threads_; ++w) {
+        threads_.emplace_back(&WorkStealingPool::WorkerLoop, this, w);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::Run(std::size_t num_tasks, const task& f) {
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    for (unsigned w = 0; w < num_threads_; ++w) {
+        std::size_t begin = num_tasks * w / num_threads_;
+        std::size_t end   = num_tasks * (w + 1) / num_threads_;
+        std::lock_guard<std::mutex> lock(queues_[w].mutex);
+        queues_[w].tasks.clear();
+        for (std::size_t i = begin; i < end; ++i) {
+            queues_[w].tasks.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        task_ = &f;
+        busy_ = num_threads_ - 1;
+        ++generation_;
+    }
+    start_.notify_all();
+    Work(0, f);
+
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    finished_.wait(lock, [this] { return busy_ == 0; });
+    task_ = nullptr;
+}
+
+void WorkStealingPool::Work(unsigned worker, const task& f) {
+    std::size_t index;
+    while (NextTask(worker, index)) {
+        f(worker, index);
+    }
+}
+
+void WorkStealingPool::WorkerLoop(unsigned worker) {
+    std::size_t done_generation{0};
+    for (;;) {
+        const task* f;
+        {
+            std::unique_lock<std::mutex> lock(state_mutex_);
+            start_.wait(lock, [&] {
+                return stop_ || generation_ != done_generation;
+            });
+            if (stop_) {
+                return;
+            }
+            done_generation = generation_;
+            f               = task_;
+        }
+        Work(worker, *f);
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        if (--busy_ == 0) {
+            finished_.notify_one();
+        }
+    }
+}
+
+bool WorkStealingPool::NextTask(unsigned worker, std::size_t& index) {
+    {
+        work_queue&                 own = queues_[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            index = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    for (unsigned i = 1; i < num_threads_; ++i) {
+        unsigned                    other{(worker + i) % num_threads_};
+        work_queue&                 victim = queues_[other];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            index = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,135 @@
+// Output of the ll1 program, run as a child process: the batch summary and
+// the report of --all-errors.
+#include <boost/test/unit_test.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <sys/wait.h>
+
+namespace {
+
+/// @brief Exit status and output of a run of the program.
+struct run_result {
+    int         status;
+    std::string out;
+    std::string err;
+};
+
+/// @brief Directory of the files written by the tests.
+std::filesystem::path TempDir() {
+    std::filesystem::path dir =
+        std::filesystem::temp_directory_path() / "ll1_cli_test";
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+std::string ReadFile(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    return {std::istreambuf_iterator<char>(in), {}};
+}
+
+/// @brief Writes `text` to a file of the temporary directory.
+std::string WriteFile(const std::string& name, const std::string& text) {
+    std::filesystem::path path = TempDir() / name;
+    std::ofstream(path) << text;
+    return path.string();
+}
+
+/// @brief Runs `./ll1` with `args`, capturing both output streams.
+run_result Run(const std::string& args) {
+    std::filesystem::path out = TempDir() / "stdout.txt";
+    std::filesystem::path err = TempDir() / "stderr.txt";
+    int status = std::system(("./ll1 " + args + " >" + out.string() + " 2>" +
+                              err.string())
+                                 .c_str());
+    return {WIFEXITED(status) ? WEXITSTATUS(status) : -1, ReadFile(out),
+            ReadFile(err)};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(cli)
+
+BOOST_AUTO_TEST_CASE(batch_summary) {
+    std::string rejected =
+        WriteFile("rejected.txt", "n = 1;\nwhile (n = 2) n = 1;\n");
+    std::string missing = (TempDir() / "missing.txt").string();
+
+    run_result run = Run("examples/grammar.txt --batch examples/input.txt " +
+                         rejected + " " + missing);
+    BOOST_TEST(run.status == 1);
+    BOOST_TEST(run.out == "Grammar is LL(1)\n"
+                          "examples/input.txt: accepted\n" +
+                              rejected + ": rejected\n" + missing +
+                              ": error: Text file not found\n"
+                              "3 files: 1 accepted, 1 rejected, 1 error\n");
+
+    run = Run("examples/grammar.txt --batch examples/input.txt");
+    BOOST_TEST(run.status == 0);
+    BOOST_TEST(run.out == "Grammar is LL(1)\n"
+                          "examples/input.txt: accepted\n"
+                          "1 file: 1 accepted, 0 rejected, 0 errors\n");
+}
+
+BOOST_AUTO_TEST_CASE(batch_list_and_jobs) {
+    std::string rejected = WriteFile("rejected.txt", "while (n = 2) n = 1;");
+    std::string list =
+        WriteFile("list.txt", "examples/input.txt\n" + rejected + "\n\n" +
+                                  rejected + "\nexamples/input.txt\n");
+
+    // The lines follow the list whatever the number of threads
+    for (const char* jobs : {"1", "3"}) {
+        run_result run =
+            Run("examples/grammar.txt --batch-list " + list + " -j " + jobs);
+        BOOST_TEST(run.status == 1);
+        BOOST_TEST(run.out == "Grammar is LL(1)\n"
+                              "examples/input.txt: accepted\n" +
+                                  rejected + ": rejected\n" + rejected +
+                                  ": rejected\n"
+                                  "examples/input.txt: accepted\n"
+                                  "4 files: 2 accepted, 2 rejected, 0 "
+                                  "errors\n");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_rejects_single_file_options) {
+    for (const char* option : {"--tree", "--history 3"}) {
+        run_result run = Run(std::string("examples/grammar.txt --batch "
+                                         "examples/input.txt ") +
+                             option);
+        BOOST_TEST(run.status == 1);
+        BOOST_TEST(run.err.starts_with(
+            "Error: --tree and --history cannot be combined with --batch"));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(all_errors_report) {
+    std::string rejected = WriteFile(
+        "rejected.txt", "while (n = 2) n = 1;\nm = ;\nk = 3;\n");
+
+    // The whole report goes to stderr
+    run_result run = Run("examples/grammar.txt " + rejected + " --all-errors");
+    BOOST_TEST(run.status == 1);
+    BOOST_TEST(run.out == "Grammar is LL(1)\n");
+    BOOST_TEST(run.err ==
+               "Parsing failed\n"
+               "Syntax error at byte 9: unexpected IGUAL, expected MENOR\n"
+               "Syntax error at byte 25: unexpected PYC, expected one of "
+               "[ IDENT NUM ]\n"
+               "2 syntax errors\n");
+
+    std::string one = WriteFile("one.txt", "m = ;\nk = 3;\n");
+    run             = Run("examples/grammar.txt " + one + " --all-errors");
+    BOOST_TEST(run.err.ends_with("\n1 syntax error\n"));
+
+    run = Run("examples/grammar.txt --all-errors --batch " + rejected + " " +
+              one);
+    BOOST_TEST(run.out == "Grammar is LL(1)\n" + rejected +
+                              ": rejected, 2 syntax errors\n" + one +
+                              ": rejected, 1 syntax error\n"
+                              "2 files: 0 accepted, 2 rejected, 0 errors\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
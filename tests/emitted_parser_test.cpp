@@ -0,0 +1,173 @@
+// Code generated by --emit-cpp and --emit-header, compiled into the tests:
+// its tables and its parsers must agree with LL1Parser. The Makefile emits
+// while_lang.cpp and while_tables.hpp from examples/grammar.txt, and int.cpp
+// and class.hpp, named after C++ keywords, from examples/grammar_1.txt.
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../include/grammar.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/ll1_runtime.hpp"
+#include "../include/parse_session.hpp"
+#include "../include/symbol_table.hpp"
+#include "gen/class.hpp"
+#include "gen/int.cpp"
+#include "gen/while_lang.cpp"
+#include "gen/while_tables.hpp"
+
+// The tables are usable at compile time: `n = 10;` and `n = ;`
+static_assert(TableParser<while_tables>::Parse(std::array<std::uint32_t, 4>{
+    while_tables::tk_IDENT, while_tables::tk_IGUAL, while_tables::tk_NUM,
+    while_tables::tk_PYC}));
+static_assert(!TableParser<while_tables>::Parse(std::array<std::uint32_t, 3>{
+    while_tables::tk_IDENT, while_tables::tk_IGUAL, while_tables::tk_PYC}));
+
+namespace {
+
+/// @brief Tokens of a file, lexed with the grammar of `parser`.
+std::vector<symbol_id> LexFile(const LL1Parser& parser,
+                               const std::string& filename) {
+    Lex lex{parser.GetGrammar().st_, filename};
+    std::vector<symbol_id> tokens;
+    for (auto chunk = lex.NextChunk(); !chunk.empty();
+         chunk      = lex.NextChunk()) {
+        tokens.insert(tokens.end(), chunk.begin(), chunk.end());
+    }
+    return tokens;
+}
+
+/// @brief Checks that the tables of a generated namespace or struct are
+/// those of `parser`.
+template <typename Tables>
+void CheckTables(const LL1Parser& parser, const Tables& tables) {
+    const symbol_table& st = parser.GetGrammar().st_;
+    BOOST_REQUIRE(tables.kNumTerminals == st.NumTerminals());
+    BOOST_REQUIRE(tables.kNumSymbols == st.Size());
+    BOOST_TEST(tables.kAxiom == parser.GetGrammar().axiom_);
+    for (symbol_id id = 0; id < st.Size(); ++id) {
+        BOOST_TEST(tables.kSymbolNames[id] == st.Name(id));
+    }
+    // The cells are as narrow as the number of productions allows, with
+    // their own marker of empty cells
+    for (symbol_id nt = st.NumTerminals(); nt < st.Size(); ++nt) {
+        for (symbol_id t = 0; t < st.NumTerminals(); ++t) {
+            std::uint32_t p    = parser.Prediction(nt, t);
+            std::uint32_t cell = tables.kTable[(nt - st.NumTerminals()) *
+                                                   st.NumTerminals() +
+                                               t];
+            BOOST_TEST(cell == (p == Grammar::kNoProduction
+                                    ? tables.kNoProduction
+                                    : p));
+        }
+    }
+}
+
+/// @brief The tables of the namespace of a generated source, seen as a
+/// struct like those of the headers.
+#define LL1_SOURCE_TABLES(name, ns)                                            \
+    struct name {                                                              \
+        static constexpr auto& kNumTerminals = ns::kNumTerminals;              \
+        static constexpr auto& kNumSymbols   = ns::kNumSymbols;                \
+        static constexpr auto& kAxiom        = ns::kAxiom;                     \
+        static constexpr auto& kSymbolNames  = ns::kSymbolNames;               \
+        static constexpr auto& kNoProduction = ns::kNoProduction;              \
+        static constexpr auto& kTable        = ns::kTable;                     \
+    }
+LL1_SOURCE_TABLES(while_lang_source, while_lang);
+LL1_SOURCE_TABLES(int_source, int_);
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(emitted_parser)
+
+BOOST_AUTO_TEST_CASE(tables_match_the_grammar) {
+    LL1Parser while_parser{"examples/grammar.txt"};
+    CheckTables(while_parser, while_tables{});
+    CheckTables(while_parser, while_lang_source{});
+
+    LL1Parser list_parser{"examples/grammar_1.txt"};
+    CheckTables(list_parser, class_{});
+    CheckTables(list_parser, int_source{});
+}
+
+BOOST_AUTO_TEST_CASE(parsers_accept_the_same_inputs) {
+    struct case_t {
+        const char* grammar;
+        const char* input;
+    };
+    const case_t cases[]{{"examples/grammar.txt", "examples/input.txt"},
+                         {"examples/grammar_1.txt", "examples/input_1.txt"}};
+    for (case_t c : cases) {
+        BOOST_TEST_CONTEXT(c.grammar) {
+            LL1Parser              parser{c.grammar};
+            ParseSession           session{parser, 0};
+            std::vector<symbol_id> valid = LexFile(parser, c.input);
+            bool is_while = std::string(c.grammar) == "examples/grammar.txt";
+
+            // Compares the three parsers on an input, and returns the result
+            auto check = [&](std::span<const symbol_id> tokens) {
+                bool expected = session.Parse(tokens);
+                if (is_while) {
+                    BOOST_TEST(while_lang::Parse(tokens.data(),
+                                                 tokens.size()) == expected);
+                    BOOST_TEST(TableParser<while_tables>::Parse(tokens) ==
+                               expected);
+                } else {
+                    BOOST_TEST(int_::Parse(tokens.data(), tokens.size()) ==
+                               expected);
+                    BOOST_TEST(TableParser<class_>::Parse(tokens) ==
+                               expected);
+                }
+                return expected;
+            };
+            BOOST_TEST(check(valid));
+
+            // Inputs with a token replaced, removed or inserted, most of
+            // them rejected
+            std::mt19937 random{7};
+            symbol_id num_terminals = parser.GetGrammar().st_.NumTerminals();
+            int       num_rejected{0};
+            for (int i = 0; i < 500; ++i) {
+                std::vector<symbol_id> tokens = valid;
+                std::size_t            pos    = random() % tokens.size();
+                symbol_id token = 1 + random() % (num_terminals - 1);
+                switch (random() % 3) {
+                case 0:
+                    tokens[pos] = token;
+                    break;
+                case 1:
+                    tokens.erase(tokens.begin() + pos);
+                    break;
+                default:
+                    tokens.insert(tokens.begin() + pos, token);
+                }
+                num_rejected += check(tokens) ? 0 : 1;
+            }
+            BOOST_TEST(num_rejected > 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parser_fed_in_pieces) {
+    LL1Parser              parser{"examples/grammar.txt"};
+    std::vector<symbol_id> tokens = LexFile(parser, "examples/input.txt");
+    for (std::size_t piece : {1, 2, 7}) {
+        while_lang::Parser        source;
+        TableParser<while_tables> header;
+        for (std::size_t pos = 0; pos < tokens.size(); pos += piece) {
+            std::size_t n = std::min(piece, tokens.size() - pos);
+            source.Feed(tokens.data() + pos, n);
+            header.Feed(std::span(tokens).subspan(pos, n));
+        }
+        BOOST_TEST(source.Accepted());
+        BOOST_TEST(header.Accepted());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
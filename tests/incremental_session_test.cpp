@@ -0,0 +1,153 @@
+// IncrementalSession: after every edit, the result of a full parse of the
+// current text, while parsing only around the edit.
+#include <boost/test/unit_test.hpp>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/incremental_session.hpp"
+#include "../include/lexer_error.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/parse_session.hpp"
+
+namespace {
+
+/// @brief examples/input.txt repeated, long enough for many blocks.
+std::string Document(std::size_t copies) {
+    std::ifstream in("examples/input.txt");
+    std::string   input{std::istreambuf_iterator<char>(in), {}};
+    std::string   document;
+    for (std::size_t i = 0; i < copies; ++i) {
+        document += input;
+    }
+    return document;
+}
+
+/// @brief Checks `session` against a full parse of `text` with recovery,
+/// whose first error is where the parse of `session` stops.
+void CheckSession(const IncrementalSession& session, ParseSession& full,
+                  const std::string& text) {
+    BOOST_REQUIRE(session.Text() == text);
+    BOOST_TEST(session.Size() == text.size());
+    bool accepted = full.ParseText(text);
+    BOOST_TEST(session.Accepted() == accepted);
+    if (!accepted && !full.Errors().empty()) {
+        BOOST_TEST(session.ErrorOffset() == full.Errors().front().offset);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(incremental)
+
+BOOST_AUTO_TEST_CASE(random_edits_match_full_parse) {
+    LL1Parser          parser{"examples/grammar.txt"};
+    IncrementalSession session{parser};
+    ParseSession       full{parser, 0};
+    full.SetRecovery(true);
+    std::string text = Document(40);
+    session.Load(text);
+    CheckSession(session, full, text);
+
+    // Snippets that break and fix statements, or add or remove lines. At
+    // most three edits pile up before they are undone, so the text is often
+    // valid again.
+    const std::vector<std::string> snippets{
+        "",  "n = 1;\n", "while (x < 10) {\n", "}\n", ";", "\n", "x", " ",
+        "= ", "(", "do {\n    n = nn;\n} while (n < 20);\n"};
+    struct edit {
+        std::size_t offset;
+        std::size_t length;
+        std::string replacement;
+    };
+    std::vector<edit> undo;
+    std::mt19937      random{2024};
+    for (int i = 0; i < 800; ++i) {
+        edit e;
+        bool is_undo = undo.size() >= 3 || (!undo.empty() && random() % 3 == 0);
+        if (is_undo) {
+            e = undo.back();
+            undo.pop_back();
+        } else {
+            e.offset = random() % (text.size() + 1);
+            e.length = random() % 4 == 0 ? random() % 300 : random() % 3;
+            e.length = std::min(e.length, text.size() - e.offset);
+            e.replacement = snippets[random() % snippets.size()];
+            undo.push_back({e.offset, e.replacement.size(),
+                            text.substr(e.offset, e.length)});
+        }
+        BOOST_TEST_CONTEXT("edit " << i << " at " << e.offset) {
+            try {
+                session.Edit(e.offset, e.length, e.replacement);
+            } catch (const LexerError&) {
+                // A space that cuts `10` into `1 0` leaves `0`, not a NUM.
+                // Undoing only restores a text that was lexed before.
+                BOOST_REQUIRE(!is_undo);
+                BOOST_REQUIRE(session.Text() == text);
+                undo.pop_back();
+                continue;
+            }
+            text.replace(e.offset, e.length, e.replacement);
+            CheckSession(session, full, text);
+
+            IncrementalSession fresh{parser};
+            fresh.Load(text);
+            BOOST_TEST(session.NumTokens() == fresh.NumTokens());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(edits_parse_few_tokens) {
+    LL1Parser          parser{"examples/grammar.txt"};
+    IncrementalSession session{parser};
+    ParseSession       full{parser, 0};
+    full.SetRecovery(true);
+    std::string text = Document(200);
+    BOOST_TEST(session.Load(text));
+    std::size_t num_tokens = session.NumTokens();
+    BOOST_TEST(session.ParsedTokens() == num_tokens);
+
+    // A statement inserted in the middle converges a block or two later
+    std::size_t middle = text.find('\n', text.size() / 2) + 1;
+    BOOST_TEST(session.Edit(middle, 0, "abc = 10;\n"));
+    text.insert(middle, "abc = 10;\n");
+    CheckSession(session, full, text);
+    BOOST_TEST(session.ParsedTokens() <
+               4 * IncrementalSession::kCheckpointInterval);
+
+    // Breaking it stops the parse there, fixing it converges again
+    BOOST_TEST(!session.Edit(middle + 4, 1, "<"));
+    text.replace(middle + 4, 1, "<");
+    CheckSession(session, full, text);
+    BOOST_TEST(session.ErrorOffset() == middle + 4);
+    BOOST_TEST(session.Edit(middle + 4, 1, "="));
+    text.replace(middle + 4, 1, "=");
+    CheckSession(session, full, text);
+    BOOST_TEST(session.ParsedTokens() <
+               4 * IncrementalSession::kCheckpointInterval);
+    BOOST_TEST(session.NumTokens() == num_tokens + 4);
+}
+
+BOOST_AUTO_TEST_CASE(failed_edits_leave_the_document) {
+    LL1Parser          parser{"examples/grammar.txt"};
+    IncrementalSession session{parser};
+    std::string        text = Document(3);
+    session.Load(text);
+    BOOST_CHECK_THROW(session.Edit(10, 1, "#"), LexerError);
+    BOOST_CHECK_THROW(session.Edit(text.size() + 1, 0, "n = 1;"),
+                      std::out_of_range);
+    BOOST_TEST(session.Text() == text);
+    BOOST_TEST(session.Accepted());
+
+    // An empty document is accepted, and can be filled again
+    BOOST_TEST(session.Edit(0, text.size(), ""));
+    BOOST_TEST(session.NumTokens() == 0);
+    BOOST_TEST(session.Edit(0, 0, text));
+    BOOST_TEST(session.Text() == text);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,174 @@
+// Chunked lexing: tokens cut by a chunk boundary, from a buffer and from a
+// file, must be lexed as in one piece.
+#include <boost/test/unit_test.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/lexer.hpp"
+#include "../include/lexer_error.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/parse_session.hpp"
+#include "../include/symbol_table.hpp"
+
+namespace {
+
+/// @brief Input built lexeme by lexeme, with the tokens it must give.
+struct expected_text {
+    std::string              text;
+    std::vector<symbol_id>   tokens;
+    std::vector<token_range> ranges;
+
+    void Token(std::string_view lexeme, symbol_id id) {
+        ranges.push_back({text.size(), text.size() + lexeme.size()});
+        text += lexeme;
+        tokens.push_back(id);
+    }
+
+    /// @brief Appends `n = 10;` with no whitespace, a statement of the
+    /// grammar of examples/grammar.txt.
+    void Statement(const symbol_table& st, std::string_view name) {
+        Token(name, st.Id("IDENT"));
+        Token("=", st.Id("IGUAL"));
+        Token("10", st.Id("NUM"));
+        Token(";", st.Id("PYC"));
+    }
+
+    /// @brief Appends statements, then spaces, until the text is `size`
+    /// bytes long.
+    void FillTo(const symbol_table& st, std::size_t size) {
+        while (text.size() + 8 < size) {
+            Statement(st, "n");
+            text += '\n';
+        }
+        text.append(size - text.size(), ' ');
+    }
+};
+
+/// @brief Tokens and ranges of every chunk of the current input of `lex`.
+void LexAll(Lex& lex, std::vector<symbol_id>& tokens,
+            std::vector<token_range>& ranges) {
+    for (auto chunk = lex.NextChunk(); !chunk.empty();
+         chunk      = lex.NextChunk()) {
+        tokens.insert(tokens.end(), chunk.begin(), chunk.end());
+        ranges.insert(ranges.end(), lex.Ranges().begin(), lex.Ranges().end());
+    }
+}
+
+/// @brief Checks that `input` gives its expected tokens, lexed from memory
+/// and from a file.
+void CheckLexes(const symbol_table& st, const expected_text& input) {
+    Lex lex{st};
+    lex.TrackRanges(true);
+
+    std::vector<symbol_id>   tokens;
+    std::vector<token_range> ranges;
+    lex.Reset(input.text);
+    LexAll(lex, tokens, ranges);
+    BOOST_TEST(tokens == input.tokens, boost::test_tools::per_element());
+    BOOST_REQUIRE_EQUAL(ranges.size(), input.ranges.size());
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        BOOST_TEST(ranges[i].begin == input.ranges[i].begin);
+        BOOST_TEST(ranges[i].end == input.ranges[i].end);
+    }
+
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "ll1_lexer_test.txt";
+    std::ofstream(path, std::ios::binary) << input.text;
+    tokens.clear();
+    ranges.clear();
+    lex.Open(path.string());
+    LexAll(lex, tokens, ranges);
+    std::filesystem::remove(path);
+    BOOST_TEST(tokens == input.tokens, boost::test_tools::per_element());
+    BOOST_REQUIRE_EQUAL(ranges.size(), input.ranges.size());
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        BOOST_TEST(ranges[i].begin == input.ranges[i].begin);
+        BOOST_TEST(ranges[i].end == input.ranges[i].end);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(lexer)
+
+BOOST_AUTO_TEST_CASE(token_across_chunk_boundary) {
+    LL1Parser           parser{"examples/grammar.txt"};
+    const symbol_table& st = parser.GetGrammar().st_;
+    // The boundary falls at every byte of the token and right around it.
+    // `while` alone is a keyword, so the held-back bytes must be lexed again
+    // to give an identifier.
+    const std::string_view name{"whileloop"};
+    for (std::size_t cut = 0; cut <= name.size() + 1; ++cut) {
+        BOOST_TEST_CONTEXT("cut after " << cut << " bytes") {
+            expected_text input;
+            input.FillTo(st, Lex::kChunkSize - cut);
+            input.Statement(st, name);
+            input.text += '\n';
+            input.Statement(st, "m");
+            CheckLexes(st, input);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(adjacent_tokens_across_chunk_boundary) {
+    LL1Parser           parser{"examples/grammar.txt"};
+    const symbol_table& st = parser.GetGrammar().st_;
+    // Statements with no whitespace, so the boundary falls between two
+    // tokens or inside one, and never in whitespace
+    for (std::size_t shift = 0; shift < 8; ++shift) {
+        BOOST_TEST_CONTEXT("shift " << shift) {
+            expected_text input;
+            input.FillTo(st, Lex::kChunkSize - 16 - shift);
+            for (int i = 0; i < 8; ++i) {
+                input.Statement(st, "abc");
+            }
+            CheckLexes(st, input);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(token_longer_than_a_chunk) {
+    LL1Parser           parser{"examples/grammar.txt"};
+    const symbol_table& st = parser.GetGrammar().st_;
+    expected_text       input;
+    input.FillTo(st, Lex::kChunkSize / 2);
+    input.Statement(st, std::string(3 * Lex::kChunkSize + 5, 'x'));
+    input.Statement(st, "m");
+    CheckLexes(st, input);
+}
+
+BOOST_AUTO_TEST_CASE(token_longer_than_max_is_rejected) {
+    LL1Parser   parser{"examples/grammar.txt"};
+    std::string text(2 * Lex::kMaxTokenSize, 'x');
+    text += " = 10;";
+    Lex lex{parser.GetGrammar().st_};
+    lex.Reset(text);
+    std::vector<symbol_id>   tokens;
+    std::vector<token_range> ranges;
+    BOOST_CHECK_THROW(LexAll(lex, tokens, ranges), LexerError);
+}
+
+BOOST_AUTO_TEST_CASE(parse_across_chunk_boundaries) {
+    LL1Parser           parser{"examples/grammar.txt"};
+    const symbol_table& st = parser.GetGrammar().st_;
+    expected_text       input;
+    input.FillTo(st, 3 * Lex::kChunkSize - 4);
+    input.Statement(st, "whileloop");
+    ParseSession session{parser, 0};
+    BOOST_TEST(session.ParseText(input.text));
+
+    // A keyword cut after its first two bytes
+    expected_text loop;
+    loop.FillTo(st, 3 * Lex::kChunkSize - 2);
+    loop.text += "while (n < 10) n = 1;";
+    BOOST_TEST(session.ParseText(loop.text));
+    loop.text[3 * Lex::kChunkSize + 7] = '=';
+    BOOST_TEST(!session.ParseText(loop.text));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+// Panic-mode recovery of ParseSession: the list of errors found in one pass.
+#include <boost/test/unit_test.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/lexer.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/parse_session.hpp"
+#include "../include/symbol_table.hpp"
+
+namespace {
+
+/// @brief Error expected at a byte offset, with symbol names.
+struct expected_error {
+    std::size_t offset;
+    std::string found;
+    std::string expected;
+};
+
+void CheckErrors(const ParseSession& session, const symbol_table& st,
+                 const std::vector<expected_error>& expected) {
+    const std::vector<syntax_error>& errors = session.Errors();
+    BOOST_REQUIRE_EQUAL(errors.size(), expected.size());
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        BOOST_TEST_CONTEXT("error " << i) {
+            BOOST_TEST(errors[i].offset == expected[i].offset);
+            BOOST_TEST(st.Name(errors[i].found) == expected[i].found);
+            BOOST_TEST(st.Name(errors[i].expected) == expected[i].expected);
+        }
+    }
+}
+
+/// @brief Three statements with an error each, between valid ones.
+const std::string kThreeErrors{"n = 1;\n"
+                               "while (n = 2) n = 1;\n"
+                               "m = ;\n"
+                               "k = 3;\n"
+                               "if (a < b) x = 1 else y = 2;\n"};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(recovery)
+
+BOOST_AUTO_TEST_CASE(reports_every_error) {
+    LL1Parser           parser{"examples/grammar.txt"};
+    const symbol_table& st = parser.GetGrammar().st_;
+    ParseSession        session{parser, 0};
+    session.SetRecovery(true);
+
+    BOOST_TEST(!session.ParseText(kThreeErrors));
+    CheckErrors(session, st,
+                {{16, "IGUAL", "MENOR"}, {32, "PYC", "var"},
+                 {58, "ELSE", "PYC"}});
+
+    std::ostringstream out;
+    session.PrintErrors(out);
+    BOOST_TEST(out.str() ==
+               "Syntax error at byte 16: unexpected IGUAL, expected MENOR\n"
+               "Syntax error at byte 32: unexpected PYC, expected one of "
+               "[ IDENT NUM ]\n"
+               "Syntax error at byte 58: unexpected ELSE, expected PYC\n");
+
+    // The same errors from a file, past a few chunks of valid statements
+    std::string prefix;
+    while (prefix.size() < 2 * Lex::kChunkSize + 3) {
+        prefix += "a = 10;\n";
+    }
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "ll1_recovery_test.txt";
+    std::ofstream(path) << prefix << kThreeErrors;
+    BOOST_TEST(!session.ParseFile(path.string()));
+    std::filesystem::remove(path);
+    std::size_t base = prefix.size();
+    CheckErrors(session, st,
+                {{base + 16, "IGUAL", "MENOR"}, {base + 32, "PYC", "var"},
+                 {base + 58, "ELSE", "PYC"}});
+}
+
+BOOST_AUTO_TEST_CASE(skipped_tokens_are_one_error) {
+    LL1Parser    parser{"examples/grammar.txt"};
+    ParseSession session{parser, 0};
+    session.SetRecovery(true);
+    // Both `=` after the first are skipped before `1` matches again
+    BOOST_TEST(!session.ParseText("m = = = 1;\nk = 3;\n"));
+    CheckErrors(session, parser.GetGrammar().st_, {{4, "IGUAL", "var"}});
+}
+
+BOOST_AUTO_TEST_CASE(errors_belong_to_the_last_parse) {
+    LL1Parser    parser{"examples/grammar.txt"};
+    ParseSession session{parser, 0};
+    session.SetRecovery(true);
+    BOOST_TEST(!session.ParseText(kThreeErrors));
+    BOOST_TEST(session.ParseText("n = 1;\nwhile (n < 2) n = 1;\n"));
+    BOOST_TEST(session.Errors().empty());
+
+    // Without recovery the parse stops at the first error
+    session.SetRecovery(false);
+    BOOST_TEST(!session.ParseText(kThreeErrors));
+    BOOST_TEST(session.Errors().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+// PushSession: the events and the result of ParseSession::ParseText on the
+// whole input, however the input is cut into pushes.
+#include <boost/test/unit_test.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/lexer_error.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/parse_events.hpp"
+#include "../include/parse_session.hpp"
+#include "../include/push_session.hpp"
+#include "../include/symbol_table.hpp"
+
+namespace {
+
+/// @brief Visitor that records the events of a parse.
+struct event_log {
+    std::vector<parse_event> events;
+
+    void EnterNonTerminal(symbol_id symbol, std::uint32_t production,
+                          std::size_t num_children, std::size_t begin) {
+        events.push_back({parse_event::ENTER, symbol, production, num_children,
+                          {begin, begin}});
+    }
+    void ShiftTerminal(symbol_id symbol, token_range range) {
+        events.push_back({parse_event::SHIFT, symbol, 0, 0, range});
+    }
+    void ExitNonTerminal(symbol_id symbol, std::size_t end) {
+        events.push_back({parse_event::EXIT, symbol, 0, 0, {end, end}});
+    }
+};
+
+/// @brief Runs a parse through `events`, returning how many there were.
+std::size_t Drain(PushSession::event_range events) {
+    std::size_t n{0};
+    for ([[maybe_unused]] const parse_event& event : events) {
+        ++n;
+    }
+    return n;
+}
+
+std::string ReadFile(const std::string& filename) {
+    std::ifstream in(filename);
+    return {std::istreambuf_iterator<char>(in), {}};
+}
+
+/// @brief Pushes `text` in pieces of random sizes up to `max_piece`, and
+/// checks the events and the result against a parse of the whole text.
+void CheckPushes(const LL1Parser& parser, std::string_view text,
+                 std::size_t max_piece, std::mt19937& random) {
+    ParseSession session{parser, 0};
+    event_log    expected;
+    bool         accepted = session.ParseText(text, expected);
+
+    PushSession              push{parser};
+    std::vector<parse_event> events;
+    for (std::size_t pos = 0; pos < text.size();) {
+        std::size_t size = 1 + random() % max_piece;
+        for (const parse_event& event : push.Push(text.substr(pos, size))) {
+            events.push_back(event);
+        }
+        pos += size;
+    }
+    for (const parse_event& event : push.Finish()) {
+        events.push_back(event);
+    }
+    BOOST_TEST(push.Done());
+    BOOST_TEST(push.Accepted() == accepted);
+
+    BOOST_REQUIRE_EQUAL(events.size(), expected.events.size());
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const parse_event& a = events[i];
+        const parse_event& b = expected.events[i];
+        BOOST_TEST_CONTEXT("event " << i) {
+            BOOST_TEST(a.kind == b.kind);
+            BOOST_TEST(a.symbol == b.symbol);
+            BOOST_TEST(a.production == b.production);
+            BOOST_TEST(a.num_children == b.num_children);
+            BOOST_TEST(a.range.begin == b.range.begin);
+            BOOST_TEST(a.range.end == b.range.end);
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(push)
+
+BOOST_AUTO_TEST_CASE(events_match_parse_text) {
+    std::mt19937 random{11};
+    for (int n : {0, 1, 2, 3}) {
+        std::string suffix  = n == 0 ? "" : "_" + std::to_string(n);
+        std::string grammar = "examples/grammar" + suffix + ".txt";
+        std::string input   = ReadFile("examples/input" + suffix + ".txt");
+        BOOST_TEST_CONTEXT(grammar) {
+            LL1Parser parser{grammar};
+            // One byte at a time cuts every token, whole pushes few
+            for (std::size_t max_piece : {1, 3, 16, 4096}) {
+                CheckPushes(parser, input, max_piece, random);
+            }
+            // Prefixes end the input inside the derivation
+            for (std::size_t size : {input.size() / 3, input.size() / 2}) {
+                CheckPushes(parser, input.substr(0, size), 5, random);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rejected_inputs) {
+    LL1Parser    parser{"examples/grammar.txt"};
+    std::mt19937 random{12};
+    std::string  input = ReadFile("examples/input.txt");
+    for (std::string_view text : {"while (n = 2) n = 1;", "n = 1; m = ;",
+                                  "do { n = 1; } while (n < 2) n = 1;"}) {
+        CheckPushes(parser, text, 3, random);
+        CheckPushes(parser, input + std::string(text), 7, random);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(large_input_in_network_sized_pushes) {
+    LL1Parser    parser{"examples/grammar.txt"};
+    std::mt19937 random{13};
+    std::string  input = ReadFile("examples/input.txt");
+    std::string  text;
+    while (text.size() < 3 * Lex::kChunkSize) {
+        text += input;
+    }
+    CheckPushes(parser, text, 1500, random);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_token) {
+    LL1Parser   parser{"examples/grammar.txt"};
+    PushSession push{parser};
+    BOOST_TEST(Drain(push.Push("n = 1;\nm = ")) > 0);
+    // Invalid bytes may start a token with the next ones, so they are only
+    // rejected once the input ends
+    Drain(push.Push("#"));
+    BOOST_CHECK_THROW(Drain(push.Finish()), LexerError);
+    BOOST_TEST(!push.Accepted());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
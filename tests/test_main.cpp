@@ -0,0 +1,5 @@
+// Entry point of the behaviour tests, built and run by `make test`. The
+// tests read the grammars in examples/, so they run from the repository
+// root.
+#define BOOST_TEST_MODULE ll1
+#include <boost/test/included/unit_test.hpp>
@@ -0,0 +1,55 @@
+// ThreadedSession: the results of ParseSession on the same inputs.
+#include <boost/test/unit_test.hpp>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/lexer.hpp"
+#include "../include/ll1_parser.hpp"
+#include "../include/parse_session.hpp"
+#include "../include/symbol_table.hpp"
+#include "../include/threaded_session.hpp"
+
+BOOST_AUTO_TEST_SUITE(threaded)
+
+BOOST_AUTO_TEST_CASE(results_match_parse_session) {
+    std::mt19937 random{5};
+    for (int n : {0, 1, 2, 3}) {
+        std::string suffix  = n == 0 ? "" : "_" + std::to_string(n);
+        std::string grammar = "examples/grammar" + suffix + ".txt";
+        std::string input   = "examples/input" + suffix + ".txt";
+        BOOST_TEST_CONTEXT(grammar) {
+            LL1Parser       parser{grammar};
+            ParseSession    session{parser, 0};
+            ThreadedSession threaded{parser};
+            BOOST_TEST(session.ParseFile(input));
+            BOOST_TEST(threaded.ParseFile(input));
+
+            std::vector<symbol_id> valid;
+            Lex                    lex{parser.GetGrammar().st_, input};
+            for (auto chunk = lex.NextChunk(); !chunk.empty();
+                 chunk      = lex.NextChunk()) {
+                valid.insert(valid.end(), chunk.begin(), chunk.end());
+            }
+
+            // The valid tokens with one replaced, then random sequences
+            symbol_id num_terminals = parser.GetGrammar().st_.NumTerminals();
+            for (int i = 0; i < 300; ++i) {
+                std::vector<symbol_id> tokens = valid;
+                if (i % 2 == 0) {
+                    tokens[random() % tokens.size()] =
+                        1 + random() % (num_terminals - 1);
+                } else {
+                    tokens.resize(random() % 20);
+                    for (symbol_id& token : tokens) {
+                        token = 1 + random() % (num_terminals - 1);
+                    }
+                }
+                BOOST_TEST(threaded.Parse(tokens) == session.Parse(tokens));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()